@@ -0,0 +1,184 @@
+/*
+ Convergence benchmark of the estimators of the density of states: each
+ estimator runs on `FixedDegreeNetwork(3, blocks)` and, at steps growing
+ geometrically up to MAX_STEPS, its entropy is compared with a reference entropy.
+ Prints CSV rows
+
+    estimator,blocks,seed,steps,seconds,visited,max_error,rms_error
+
+ where seconds is the CPU time of the estimator alone (without the evaluations of
+ the error), visited is the fraction of the bins of the reference that the
+ estimator knows, and the errors are the max and rms of |S - S_ref| over those
+ bins, after normalizing both to \sum(exp(S)) == 1 (NAN until every bin is known).
+ This compares estimators by the error they reach in a given time, instead of
+ by their round-trips (as in figure 2).
+
+ - BLOCKS is a comma-separated list of blocks, "4,8" by default;
+ - MAX_STEPS is the last number of steps, 2^24 by default;
+ - SEEDS is the number of independent runs of each estimator, 1 by default;
+ - ESTIMATORS is a comma-separated subset of the estimators below, all by default;
+ - The reference of B blocks is read from reference_B<B>.dat (in the format of
+   `WangLandauSampler::export_entropy`; e.g. exact, from examples/exact_entropy.cpp
+   for up to 5 blocks) and, if the file does not exist, it is
+   computed by the "tmmc" estimator over REFERENCE_STEPS steps (2^28 by default)
+   and saved to it.
+
+ An estimator is a class with `run(steps)`, which advances it to `steps` Markov
+ steps in total, `get_steps()` and `entropy()`, its estimate with a value per bin
+ and NAN where unknown; a new one only needs a line in `benchmark_estimator`.
+*/
+#include <cstdio>
+#include <ctime>
+#include <vector>
+
+#include "sampler.h"
+
+const double F_FINAL = 0;  // never reached: the estimators run until `run` stops them
+const double FLATNESS = 0.8;
+
+//! Wang-Landau with f halved when the histogram is flat ("wang_landau"), with
+//! the 1/t schedule ("one_over_t"), with the entropy of its transition matrix
+//! ("tmmc") and with the hybrid steps of `set_transition_matrix` ("hybrid").
+class WangLandauEstimator {
+protected:
+    FixedDegreeNetwork network;
+    Histogram<unsigned int> histogram;
+    Random rng;
+    WangLandauSampler sampler;
+    bool transition_matrix;
+public:
+    WangLandauEstimator(std::string const& name, unsigned int blocks, unsigned int seed) :
+    network(3, blocks), histogram(0, network.get_triangles(), network.get_triangles()), rng(seed),
+    sampler(rng, histogram, network), transition_matrix(name == "tmmc" or name == "hybrid") {
+        sampler.set_one_over_t(name == "one_over_t");
+        sampler.set_transition_matrix(transition_matrix, name == "hybrid");
+    }
+
+    inline void run(unsigned long long steps) {sampler.sample_until(F_FINAL, 5, FLATNESS, steps);}
+    inline unsigned long long get_steps() const {return sampler.get_steps();}
+
+    std::vector<double> entropy() const {
+        if (transition_matrix)
+            return sampler.get_transition_matrix().entropy();
+        std::vector<double> result(sampler.get_entropy());
+        for (double & value : result)
+            if (value == 0)
+                value = NAN;
+        return result;
+    }
+};
+
+//! `entropy` normalized to \sum(exp(S)) == 1 over the bins where `reference` is known.
+std::vector<double> normalized(std::vector<double> entropy, std::vector<double> const& reference) {
+    double S_max = -std::numeric_limits<double>::infinity();
+    for (unsigned int bin = 0; bin < reference.size(); bin++)
+        if (not std::isnan(reference[bin]) and not std::isnan(entropy[bin]))
+            S_max = std::max(S_max, entropy[bin]);
+    double C = 0;
+    for (unsigned int bin = 0; bin < reference.size(); bin++)
+        if (not std::isnan(reference[bin]) and not std::isnan(entropy[bin]))
+            C += exp(entropy[bin] - S_max);
+    C = S_max + log(C);
+    for (double & value : entropy)
+        value -= C;
+    return entropy;
+}
+
+double cpu_seconds() {
+    return std::clock()/(double)CLOCKS_PER_SEC;
+}
+
+template <class Estimator>
+void benchmark(std::string const& name, unsigned int blocks, unsigned int seed,
+               std::vector<double> const& reference, unsigned long long max_steps) {
+    Estimator estimator(name, blocks, seed);
+    std::vector<double> S_ref(normalized(reference, reference));
+    double seconds = 0;
+    for (double steps = 1 << 12; steps <= max_steps*1.0001; steps *= sqrt(2.)) {
+        double start = cpu_seconds();
+        estimator.run((unsigned long long)steps);
+        seconds += cpu_seconds() - start;
+
+        std::vector<double> S(estimator.entropy());
+        unsigned int known = 0, visited = 0;
+        for (unsigned int bin = 0; bin < S_ref.size(); bin++) {
+            known += not std::isnan(S_ref[bin]);
+            visited += not std::isnan(S_ref[bin]) and not std::isnan(S[bin]);
+        }
+        double max_error = NAN, rms_error = NAN;
+        if (visited == known) {
+            S = normalized(S, S_ref);
+            max_error = rms_error = 0;
+            for (unsigned int bin = 0; bin < S_ref.size(); bin++)
+                if (not std::isnan(S_ref[bin])) {
+                    max_error = std::max(max_error, std::abs(S[bin] - S_ref[bin]));
+                    rms_error += (S[bin] - S_ref[bin])*(S[bin] - S_ref[bin]);
+                }
+            rms_error = sqrt(rms_error/known);
+        }
+        printf("%s,%d,%d,%llu,%.3f,%.3f,%.6f,%.6f\n", name.c_str(), blocks, seed, estimator.get_steps(),
+               seconds, visited*1./known, max_error, rms_error);
+        fflush(stdout);
+    }
+}
+
+//! runs the estimator `name`.
+void benchmark_estimator(std::string const& name, unsigned int blocks, unsigned int seed,
+                         std::vector<double> const& reference, unsigned long long max_steps) {
+    if (name == "wang_landau" or name == "one_over_t" or name == "tmmc" or name == "hybrid")
+        benchmark<WangLandauEstimator>(name, blocks, seed, reference, max_steps);
+    else {
+        std::cout << "unknown estimator \"" << name << "\"" << std::endl;
+        exit(1);
+    }
+}
+
+//! the reference entropy of `blocks`, from its file or computed and saved to it.
+std::vector<double> reference_entropy(unsigned int blocks) {
+    std::string file_name(format("reference_B%d.dat", blocks));
+    if (not std::ifstream(file_name.c_str()).good()) {
+        char *env_reference_steps = getenv("REFERENCE_STEPS");
+        unsigned long long steps = env_reference_steps == NULL ? 1ull << 28 : atoll(env_reference_steps);
+        std::cerr << "computing " << file_name << " in " << steps << " steps" << std::endl;
+
+        WangLandauEstimator estimator("tmmc", blocks, 1000);
+        estimator.run(steps);
+        std::vector<double> S(estimator.entropy());
+        S = normalized(S, S);
+        std::vector<std::vector<double> > data;
+        for (unsigned int bin = 0; bin < S.size(); bin++)
+            if (not std::isnan(S[bin]))
+                data.push_back({(double)bin, S[bin]});
+        io::save(data, file_name);
+    }
+    FixedDegreeNetwork network(3, blocks);
+    std::vector<double> result(network.get_triangles() + 1, NAN);
+    for (std::vector<double> const& row : io::load<double>(file_name))
+        result[(unsigned int)row[0]] = row[1];
+    return result;
+}
+
+int main() {
+    char *env_blocks = getenv("BLOCKS");
+    std::vector<std::string> blocks_list(split(env_blocks == NULL ? "4,8" : env_blocks, ','));
+
+    char *env_max_steps = getenv("MAX_STEPS");
+    unsigned long long max_steps = env_max_steps == NULL ? 1ull << 24 : atoll(env_max_steps);
+
+    char *env_seeds = getenv("SEEDS");
+    unsigned int seeds = env_seeds == NULL ? 1 : (unsigned int)atoi(env_seeds);
+
+    char *env_estimators = getenv("ESTIMATORS");
+    std::vector<std::string> estimators(split(env_estimators == NULL ? "wang_landau,one_over_t,tmmc,hybrid" :
+                                              env_estimators, ','));
+
+    printf("estimator,blocks,seed,steps,seconds,visited,max_error,rms_error\n");
+    for (std::string const& blocks_string : blocks_list) {
+        unsigned int blocks = (unsigned int)atoi(blocks_string.c_str());
+        std::vector<double> reference(reference_entropy(blocks));
+        for (std::string const& name : estimators)
+            for (unsigned int seed = 1; seed <= seeds; seed++)
+                benchmark_estimator(name, blocks, seed, reference, max_steps);
+    }
+    return 0;
+}
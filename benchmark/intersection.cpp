@@ -0,0 +1,80 @@
+/*
+ Microbenchmark of the intersection kernels (see source/intersection.h) against
+ `std::set_intersection`, as used to update the triangles of a link before the
+ links were stored in sorted arrays.
+
+ For each degree, intersects pairs of random sorted lists of that size drawn
+ from 4*degree nodes and prints the time per intersection in ns:
+
+    kernel degree ns_per_intersection
+*/
+#include <chrono>
+#include <cstdio>
+#include <set>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+
+#include "intersection.h"
+#include "random.h"
+
+const unsigned int PAIRS = 256;
+
+template <class Function>
+double time_per_pair(Function function, unsigned int degree) {
+    // repeat such that every measure intersects around 2^26 elements
+    unsigned int repetitions = std::max(1u, (1u << 26)/(PAIRS*degree));
+    volatile size_t sink = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned int repetition = 0; repetition < repetitions; repetition++)
+        for (unsigned int pair = 0; pair < PAIRS; pair++)
+            sink = sink + function(pair);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count()/(repetitions*PAIRS);
+}
+
+int main() {
+    Random rng(1);
+    printf("# kernel degree ns_per_intersection (dispatch: %s)\n", intersection::kernel_name());
+
+    for (unsigned int degree = 4; degree <= 1024; degree *= 4) {
+        std::vector<std::set<unsigned int> > sets(2*PAIRS);
+        for (unsigned int i = 0; i < sets.size(); i++)
+            while (sets[i].size() < degree)
+                sets[i].insert(rng.R(0, 4*degree));
+        std::vector<std::vector<unsigned int> > lists(sets.size());
+        for (unsigned int i = 0; i < sets.size(); i++)
+            lists[i].assign(sets[i].begin(), sets[i].end());
+        std::vector<unsigned int> out(degree);
+
+        printf("std::set_intersection(std::set) %d %.1f\n", degree, time_per_pair([&](unsigned int pair) {
+            std::vector<unsigned int> result;
+            std::set_intersection(sets[2*pair].begin(), sets[2*pair].end(),
+                                  sets[2*pair + 1].begin(), sets[2*pair + 1].end(), std::back_inserter(result));
+            return result.size();
+        }, degree));
+        printf("std::set_intersection(vector) %d %.1f\n", degree, time_per_pair([&](unsigned int pair) {
+            std::vector<unsigned int> result;
+            std::set_intersection(lists[2*pair].begin(), lists[2*pair].end(),
+                                  lists[2*pair + 1].begin(), lists[2*pair + 1].end(), std::back_inserter(result));
+            return result.size();
+        }, degree));
+        printf("count_scalar %d %.1f\n", degree, time_per_pair([&](unsigned int pair) {
+            return intersection::count_scalar(lists[2*pair].data(), degree, lists[2*pair + 1].data(), degree);
+        }, degree));
+#ifdef TRIANGLES_X86_SIMD
+        if (__builtin_cpu_supports("sse4.2"))
+            printf("count_sse42 %d %.1f\n", degree, time_per_pair([&](unsigned int pair) {
+                return intersection::count_sse42(lists[2*pair].data(), degree, lists[2*pair + 1].data(), degree);
+            }, degree));
+        if (__builtin_cpu_supports("avx2"))
+            printf("count_avx2 %d %.1f\n", degree, time_per_pair([&](unsigned int pair) {
+                return intersection::count_avx2(lists[2*pair].data(), degree, lists[2*pair + 1].data(), degree);
+            }, degree));
+#endif
+        printf("intersect %d %.1f\n", degree, time_per_pair([&](unsigned int pair) {
+            return intersection::intersect(lists[2*pair].data(), degree, lists[2*pair + 1].data(), degree, out.data());
+        }, degree));
+    }
+    return 0;
+}
@@ -0,0 +1,227 @@
+/*
+ Throughput benchmark of the hot path of the Markov chain: the updates of the
+ network, the proposer and the steps of the three samplers, on networks of
+ `FixedDegreeNetwork(degree, blocks)` over a sweep of nodes and degrees, and on
+ heterogeneous networks with a power-law degree distribution (and the network
+ of the file NETWORK, if defined). For each counter of motifs.h, it also measures
+ the count from scratch (for triangles, the count kept by the network), the
+ incremental updates of `MotifNetwork`, its `delta_motifs` and the steps of
+ Wang-Landau on it. Prints CSV rows
+
+    benchmark,network,nodes,degree,ns_per_op,ops_per_second
+
+ where the degree is the mean degree. With the CSV of a previous run as argument
+ (or in BASELINE, as in `BASELINE=baseline.csv make benchmark`),
+
+    ./benchmark_markov_chain baseline.csv
+
+ it also prints the ns_per_op of the baseline and the speedup of this run, so
+ that commits can be compared (the machine should be otherwise idle).
+*/
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+#include "sampler.h"
+#include "motifs.h"
+
+const unsigned int STEPS = 1 << 18;         // operations per measure
+const unsigned int WARM_UP_STEPS = 1 << 16;  // uniform steps before measuring the samplers
+const unsigned int MOTIF_STEPS = 1 << 16;    // operations per measure of the motifs
+
+template <class Function>
+double ns_per_op(unsigned int ops, Function function) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()/ops;
+}
+
+//! exposes `update_triangles` to the benchmark.
+class BenchmarkNetwork : public Network {
+public:
+    BenchmarkNetwork(Network const& network) : Network(network) {}
+    using Network::update_triangles;
+};
+
+//! A network with a power-law degree distribution of exponent `gamma`, from
+//! `min_degree` to sqrt(nodes), by the configuration model without the stubs
+//! that would repeat a link or make a loop. The minimum degree avoids the nodes
+//! whose neighbours are all linked to a hub, where `FixedDegreeProposer::old_link`
+//! cannot find a valid link.
+Network heterogeneous_network(unsigned int nodes, unsigned int min_degree, double gamma, Random & rng) {
+    unsigned int max_degree = (unsigned int)sqrt(nodes);
+    std::vector<unsigned int> stubs;
+    for (unsigned int node = 0; node < nodes; node++) {
+        double degree = min_degree*pow(1 - rng.R(), -1/(gamma - 1));
+        for (unsigned int stub = 0; stub < std::min((unsigned int)degree, max_degree); stub++)
+            stubs.push_back(node);
+    }
+    for (unsigned int i = (unsigned int)stubs.size() - 1; i > 0; i--)
+        std::swap(stubs[i], stubs[rng.R(0, i + 1)]);
+
+    std::vector<std::set<unsigned int> > links(nodes);
+    for (unsigned int i = 0; i + 1 < stubs.size(); i += 2)
+        if (stubs[i] != stubs[i + 1]) {
+            links[stubs[i]].insert(stubs[i + 1]);
+            links[stubs[i + 1]].insert(stubs[i]);
+        }
+    return Network(nodes, links);
+}
+
+std::map<std::string, double> baseline;  // ns_per_op by benchmark,network,nodes,degree
+
+std::string key(std::string benchmark, std::string network, unsigned int nodes, double degree) {
+    return format("%s,%s,%d,%.2f", benchmark.c_str(), network.c_str(), nodes, degree);
+}
+
+void report(std::string benchmark, std::string network, Network const& graph, double ns) {
+    double degree = 2.*graph.get_links_count()/graph.getN();
+    std::string row = key(benchmark, network, graph.getN(), degree);
+    printf("%s,%.2f,%.4e", row.c_str(), ns, 1e9/ns);
+    if (baseline.count(row))
+        printf(",%.2f,%.3f", baseline[row], baseline[row]/ns);
+    printf("\n");
+    fflush(stdout);
+}
+
+//! time per step of a sampler on a `NetworkType`, after `WARM_UP_STEPS` uniform steps from the initial network.
+template <class SamplerType, class NetworkType, class... Arguments>
+double sampler_ns(Network const& initial, unsigned int steps, Arguments... arguments) {
+    NetworkType network(initial);
+    Random rng(2);
+    Histogram<unsigned int> warm_up_histogram(0, 1, 1);
+    BasicUniformSampler<NetworkType> warm_up(rng, warm_up_histogram, network);
+    unsigned int start = network.get_motifs();
+    for (unsigned int step = 0; step < WARM_UP_STEPS; step++)
+        warm_up.markov_step();
+
+    unsigned int upper = 2*std::max(start, network.get_motifs()) + 16;
+    Histogram<unsigned int> histogram(0, upper, upper);
+    SamplerType sampler(rng, histogram, network, arguments...);
+    return ns_per_op(steps, [&]() {
+        for (unsigned int step = 0; step < steps; step++)
+            sampler.markov_step();
+    });
+}
+
+template <class Counter>
+void benchmark_motif(std::string name, Network const& initial) {
+    Random rng(1);
+    volatile long long sink = 0;
+    std::string motif(Counter::name());
+
+    unsigned int counts = std::max(1u, MOTIF_STEPS/initial.getN());
+    report(motif + "_count", name, initial, ns_per_op(counts, [&]() {
+        for (unsigned int op = 0; op < counts; op++)
+            sink = sink + Counter::count(initial);
+    }));
+
+    {
+        MotifNetwork<Counter> network(initial);
+        std::vector<Link> links(1024);
+        for (Link & link : links)
+            link = network.get_link(rng.R(0, network.get_links_count()));
+        report(motif + "_remove_add_link", name, network, ns_per_op(MOTIF_STEPS, [&]() {
+            for (unsigned int op = 0; op < MOTIF_STEPS/2; op++) {
+                Link const& link = links[op % links.size()];
+                network.remove_link(link.first, link.second);
+                network.add_link(link.first, link.second);
+            }
+        }));
+    }
+
+    {
+        MotifNetwork<Counter> network(initial);
+        FixedDegreeProposer proposer(rng);
+        std::vector<GeneratedProposal> proposals(1024);
+        for (GeneratedProposal & proposal : proposals)
+            proposal = proposer.generate_proposal(network);
+        report(motif + "_delta_motifs", name, network, ns_per_op(MOTIF_STEPS, [&]() {
+            for (unsigned int op = 0; op < MOTIF_STEPS; op++)
+                sink = sink + network.delta_motifs(proposals[op % proposals.size()]);
+        }));
+    }
+
+    report(motif + "_wang_landau_markov_step", name, initial,
+           sampler_ns<BasicWangLandauSampler<MotifNetwork<Counter> >, MotifNetwork<Counter> >(initial, MOTIF_STEPS));
+}
+
+void benchmark(std::string name, Network const& initial) {
+    Random rng(1);
+    volatile unsigned long long sink = 0;
+
+    // the same links are removed and added back: two updates of the network per pair
+    {
+        Network network(initial);
+        std::vector<Link> links(1024);
+        for (Link & link : links)
+            link = network.get_link(rng.R(0, network.get_links_count()));
+        report("remove_add_link", name, network, ns_per_op(STEPS, [&]() {
+            for (unsigned int op = 0; op < STEPS/2; op++) {
+                Link const& link = links[op % links.size()];
+                network.remove_link(link.first, link.second);
+                network.add_link(link.first, link.second);
+            }
+        }));
+    }
+
+    // updates of the triangles of existing links, added and removed such that they cancel
+    {
+        BenchmarkNetwork network(initial);
+        std::vector<Link> links(1024);
+        for (Link & link : links)
+            link = network.get_link(rng.R(0, network.get_links_count()));
+        report("update_triangles", name, network, ns_per_op(STEPS, [&]() {
+            for (unsigned int op = 0; op < STEPS/2; op++) {
+                Link const& link = links[op % links.size()];
+                network.update_triangles(link.first, link.second, true);
+                network.update_triangles(link.first, link.second, false);
+            }
+        }));
+    }
+
+    {
+        Network network(initial);
+        FixedDegreeProposer proposer(rng);
+        report("generate_proposal", name, network, ns_per_op(STEPS, [&]() {
+            for (unsigned int op = 0; op < STEPS; op++)
+                sink = sink + proposer.generate_proposal(network).new_link2.first;
+        }));
+    }
+
+    report("uniform_markov_step", name, initial, sampler_ns<UniformSampler, Network>(initial, STEPS));
+    report("canonic_markov_step", name, initial, sampler_ns<CanonicSampler, Network>(initial, STEPS, 0.5));
+    report("wang_landau_markov_step", name, initial, sampler_ns<WangLandauSampler, Network>(initial, STEPS));
+
+    benchmark_motif<TriangleCounter>(name, initial);
+    benchmark_motif<WedgeCounter>(name, initial);
+    benchmark_motif<SquareCounter>(name, initial);
+    benchmark_motif<CliqueCounter>(name, initial);
+}
+
+int main(int argc, char** argv) {
+    char *baseline_file = argc > 1 ? argv[1] : getenv("BASELINE");
+    if (baseline_file != NULL)
+        for (std::vector<std::string> const& row : io::load<std::string>(baseline_file)) {
+            std::vector<std::string> columns(split(row[0], ','));
+            if (columns.size() >= 5 and columns[0] != "benchmark")
+                baseline[join(std::vector<std::string>(columns.begin(), columns.begin() + 4), ",")] =
+                        atof(columns[4].c_str());
+        }
+
+    printf("benchmark,network,nodes,degree,ns_per_op,ops_per_second%s\n",
+           baseline_file != NULL ? ",baseline_ns_per_op,speedup" : "");
+    for (unsigned int nodes = 256; nodes <= 65536; nodes *= 16)
+        for (unsigned int degree = 3; degree <= 31; degree = 2*degree + 1)
+            benchmark("fixed_degree", FixedDegreeNetwork(degree, nodes/(degree + 1)));
+
+    Random rng(3);
+    for (unsigned int nodes = 1024; nodes <= 16384; nodes *= 16)
+        benchmark("power_law", heterogeneous_network(nodes, 4, 2.5, rng));
+
+    char *env_network = getenv("NETWORK");
+    if (env_network != NULL)
+        benchmark("file", Network(env_network));
+    return 0;
+}
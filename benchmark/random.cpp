@@ -0,0 +1,62 @@
+/*
+ Benchmark of the random number generator (see source/random.h) and of the
+ samplers that use it. Compile with -DTRIANGLES_MT19937 to compare with
+ `std::mt19937`. Prints:
+
+    name ns_per_call       (for the generator)
+    name steps_per_second  (for the samplers, on a network of 4*BLOCKS nodes)
+*/
+#include <chrono>
+#include <cstdio>
+
+#include "sampler.h"
+
+const unsigned int CALLS = 1 << 26;
+const unsigned int STEPS = 1 << 20;
+const unsigned int BLOCKS = 64;
+
+template <class Function>
+double seconds(Function function) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <class SamplerType>
+double steps_per_second() {
+    FixedDegreeNetwork network(3, BLOCKS);
+    Histogram<unsigned int> histogram(0, network.get_triangles(), network.get_triangles());
+    Random rng(2);
+    SamplerType sampler(rng, histogram, network);
+    return STEPS/seconds([&]() {
+        for (unsigned int step = 0; step < STEPS; step++)
+            sampler.markov_step();
+    });
+}
+
+int main() {
+#ifdef TRIANGLES_MT19937
+    printf("# engine std::mt19937\n");
+#else
+    printf("# engine xoshiro256**\n");
+#endif
+    Random rng(1);
+    volatile double sink = 0;
+
+    printf("R(min,max) %.2f\n", 1e9/CALLS*seconds([&]() {
+        unsigned long long sum = 0;
+        for (unsigned int call = 0; call < CALLS; call++)
+            sum += rng.R(0, 1000 + (call & 7));
+        sink = sink + sum;
+    }));
+    printf("R() %.2f\n", 1e9/CALLS*seconds([&]() {
+        double sum = 0;
+        for (unsigned int call = 0; call < CALLS; call++)
+            sum += rng.R();
+        sink = sink + sum;
+    }));
+
+    printf("UniformSampler %.3e\n", steps_per_second<UniformSampler>());
+    printf("WangLandauSampler %.3e\n", steps_per_second<WangLandauSampler>());
+    return 0;
+}
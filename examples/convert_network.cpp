@@ -0,0 +1,33 @@
+/*
+ Converts a network in a list of links (e.g. examples/input_network.dat) to the
+ binary format of `Network::save_binary`, which `Network(std::string path)`
+ loads without parsing, renumbering or counting triangles.
+
+ Usage: ./convert_network input_network.dat output_network.bin
+*/
+#include <chrono>
+
+#include "network.h"
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {std::cout << "usage: " << argv[0] << " INPUT OUTPUT" << std::endl; exit(1);}
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Network network(argv[1]);
+    std::cout << "loaded " << network.getN() << " nodes, " << network.get_links_count() << " links and "
+              << network.get_triangles() << " triangles in " << seconds_since(start) << "s ("
+              << network.get_parse_statistics().megabytes_per_second() << " MB/s)" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    network.save_binary(argv[2]);
+    std::cout << "saved in " << seconds_since(start) << "s" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    Network loaded(argv[2]);
+    std::cout << "loaded the binary network in " << seconds_since(start) << "s" << std::endl;
+    return 0;
+}
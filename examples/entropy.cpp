@@ -4,6 +4,16 @@
 
  - The network size is 4*BLOCKS;
  - Increasing ROUND_TRIPS improves the convergence of Wang-Landau;
+ - WL_STEPS is the number of WL steps (halvings of f), 15 by default;
+ - If F_FINAL is defined, the simulation instead runs until f < F_FINAL, and then
+   - if FLATNESS is defined (e.g. 0.8), WL steps end when the histogram is flat
+     instead of after ROUND_TRIPS round-trips;
+   - if ONE_OVER_T is defined, f follows the 1/t schedule once f < 1/t;
+   - if TMMC is defined, every proposal is also collected into a transition matrix,
+     whose entropy is exported too (entropy_tm_*.dat); with TMMC=hybrid, each WL
+     step restarts from that entropy;
+ - If CHECKPOINT is defined, the state of the simulation is saved to that file every
+   5 minutes and, if the file exists, the simulation continues from it.
 
  Each run of this code is a single WL simulation. After it finished, the output
  is an approximation of the DOS and histogram.
@@ -28,7 +38,11 @@ int main() {
     if (env_round_trips == NULL) {std::cout << "ROUND_TRIPS not defined" << std::endl; exit(1);}
     unsigned int round_trips = (unsigned int)atoi(env_round_trips);
 
-    unsigned int total_wl_steps = 15;
+    char *env_wl_steps = getenv("WL_STEPS");
+    unsigned int total_wl_steps = env_wl_steps == NULL ? 15 : (unsigned int)atoi(env_wl_steps);
+
+    char *env_f_final = getenv("F_FINAL");
+    char *env_flatness = getenv("FLATNESS");
 
     FixedDegreeNetwork network(3, blocks);
 
@@ -37,17 +51,39 @@ int main() {
 
     WangLandauSampler sampler(rng, histogram, network);
 
-    // warm up
-    while (network.get_triangles() != 0)
-        sampler.markov_step();
+    char *env_checkpoint = getenv("CHECKPOINT");
+    if (env_checkpoint != NULL and std::ifstream(env_checkpoint).good())
+        sampler.load_checkpoint(env_checkpoint);
+    else {
+        char *env_tmmc = getenv("TMMC");
+        if (env_f_final != NULL and env_tmmc != NULL)
+            sampler.set_transition_matrix(true, std::string(env_tmmc) == "hybrid");
+
+        // warm up
+        while (network.get_triangles() != 0)
+            sampler.markov_step();
+    }
+    if (env_checkpoint != NULL)
+        sampler.set_checkpoint(env_checkpoint, 300);
+
+    if (env_f_final != NULL) {
+        sampler.set_one_over_t(getenv("ONE_OVER_T") != NULL);
+        sampler.sample_until(atof(env_f_final), round_trips, env_flatness == NULL ? 0 : atof(env_flatness));
 
-    std::vector<std::vector<double> > result;
+        sampler.export_entropy(format("fig1_results/entropy_B%d_S%d.dat", blocks, round_trips));
+        histogram.export_histogram(format("fig1_results/histogram_wl_B%d_S%d.dat", blocks, round_trips));
+        if (getenv("TMMC") != NULL)
+            sampler.export_transition_matrix_entropy(format("fig1_results/entropy_tm_B%d_S%d.dat", blocks, round_trips));
+        return 0;
+    }
 
-    for (unsigned int step = 0; step < total_wl_steps; step++) {
-        histogram.reset();
+    while (sampler.get_wl_step() < total_wl_steps) {
+        if (sampler.get_round_trip() == 0)
+            histogram.reset();
 
-        for (unsigned int round_trip = 0; round_trip < round_trips; round_trip++) {
+        while (sampler.get_round_trip() < round_trips) {
             sampler.perform_round_trip();
+            sampler.checkpoint_if_due();
         }
         sampler.wang_landau_step();
 
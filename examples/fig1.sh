@@ -9,7 +9,7 @@ do
 export ROUND_TRIPS
 
 ### compile and execute
-g++ -std=c++11 examples/entropy.cpp -Isource -o pp && ./pp
+g++ -std=c++11 -pthread examples/entropy.cpp -Isource -o pp && ./pp
 
 done
 done
@@ -9,7 +9,7 @@ do
 export ROUND_TRIPS
 
 ### compile and execute
-g++ -std=c++11 examples/round_trip_wl.cpp -Isource -o pp && ./pp
+g++ -std=c++11 -pthread examples/round_trip_wl.cpp -Isource -o pp && ./pp
 
 done
 done
@@ -0,0 +1,62 @@
+/*
+ This code samples networks with the fixed weights of an entropy computed before
+ (see source/multicanonical.h), e.g. by entropy.cpp, so that every number of
+ triangles is about equally sampled, and reweights them into canonic averages.
+
+ - The network size is 4*BLOCKS;
+ - ENTROPY is the file of the entropy, e.g. fig1_results/entropy_B4_S4.dat;
+ - CHAINS is the number of independent chains (default: the number of cores);
+ - THREADS is the number of threads (default: the number of cores);
+ - SAMPLES is the number of samples per chain (default: 10000), THINNING steps
+   apart (default: 100);
+ - if NETWORKS is defined, the first NETWORKS samples of each number of triangles
+   and chain are saved to output/.
+
+ The output is the entropy corrected by the visits of the chains, the mean of the
+ observables per number of triangles and their canonic averages at a few betas.
+*/
+
+#include "multicanonical.h"
+
+int main() {
+    char *env_blocks = getenv("BLOCKS");
+    if (env_blocks == NULL) {std::cout << "BLOCKS not defined" << std::endl; exit(1);}
+    unsigned int blocks = (unsigned int)atoi(env_blocks);
+
+    char *env_entropy = getenv("ENTROPY");
+    if (env_entropy == NULL) {std::cout << "ENTROPY not defined" << std::endl; exit(1);}
+
+    char *env_threads = getenv("THREADS");
+    unsigned int threads = env_threads == NULL ? parallel::threads() : (unsigned int)atoi(env_threads);
+
+    char *env_chains = getenv("CHAINS");
+    unsigned int chains = env_chains == NULL ? threads : (unsigned int)atoi(env_chains);
+
+    char *env_samples = getenv("SAMPLES");
+    unsigned int samples = env_samples == NULL ? 10000 : (unsigned int)atoi(env_samples);
+
+    char *env_thinning = getenv("THINNING");
+    unsigned int thinning = env_thinning == NULL ? 100 : (unsigned int)atoi(env_thinning);
+
+    FixedDegreeNetwork network(3, blocks);
+
+    MulticanonicalSampler sampler(network, 0, network.get_triangles(), env_entropy, chains);
+    char *env_networks = getenv("NETWORKS");
+    if (env_networks != NULL)
+        sampler.set_network_output(format("output/network_B%d", blocks), (unsigned int)atoi(env_networks));
+
+    // observables: the number of triangles and the fraction of nodes in a triangle
+    sampler.sample(samples, thinning, {"triangles", "nodes_in_triangles"}, [](Network const& sample) {
+        unsigned int nodes = 0;
+        for (unsigned int node = 0; node < sample.getN(); node++)
+            nodes += sample.get_node_triangles(node) > 0;
+        return std::vector<double>{(double)sample.get_triangles(), nodes/(double)sample.getN()};
+    }, threads);
+
+    sampler.export_entropy(format("multicanonical_entropy_B%d.dat", blocks));
+    sampler.observables().export_observables(format("multicanonical_observables_B%d.dat", blocks));
+    for (double beta : {-1., 0., 0.5, 1., 2.})
+        std::cout << "beta " << beta << ": <triangles> = " << sampler.canonic_average(0, beta)
+                  << ", <nodes_in_triangles> = " << sampler.canonic_average(1, beta) << std::endl;
+    return 0;
+}
@@ -0,0 +1,46 @@
+/*
+ This code computes the same entropy as entropy.cpp with several walkers that
+ share one Wang-Landau entropy (see source/multiple_walkers.h), and reports the
+ wall time of the simulation.
+
+ - The network size is 4*BLOCKS;
+ - Increasing ROUND_TRIPS improves the convergence of Wang-Landau; they are
+   counted over all walkers;
+ - WALKERS is the number of walkers (default: the number of cores);
+ - THREADS is the number of threads (default: the number of cores).
+
+ Comparing the wall time with WALKERS=1 shows how the WL steps shorten with the
+ number of walkers.
+*/
+
+#include "multiple_walkers.h"
+
+int main() {
+    char *env_blocks = getenv("BLOCKS");
+    if (env_blocks == NULL) {std::cout << "BLOCKS not defined" << std::endl; exit(1);}
+    unsigned int blocks = (unsigned int)atoi(env_blocks);
+
+    char *env_round_trips = getenv("ROUND_TRIPS");
+    if (env_round_trips == NULL) {std::cout << "ROUND_TRIPS not defined" << std::endl; exit(1);}
+    unsigned int round_trips = (unsigned int)atoi(env_round_trips);
+
+    char *env_threads = getenv("THREADS");
+    unsigned int threads = env_threads == NULL ? parallel::threads() : (unsigned int)atoi(env_threads);
+
+    char *env_walkers = getenv("WALKERS");
+    unsigned int walkers = env_walkers == NULL ? threads : (unsigned int)atoi(env_walkers);
+
+    unsigned int total_wl_steps = 15;
+
+    FixedDegreeNetwork network(3, blocks);
+
+    MultipleWalkerWangLandau sampler(network, 0, network.get_triangles(), walkers);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    sampler.sample(total_wl_steps, round_trips, 1000, threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << walkers << " walkers on " << threads << " threads: " << seconds << " s" << std::endl;
+    sampler.export_entropy(format("multiple_walkers_B%d_S%d_W%d.dat", blocks, round_trips, walkers));
+    return 0;
+}
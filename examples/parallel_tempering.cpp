@@ -0,0 +1,88 @@
+// g++ -std=c++11 -O2 -pthread examples/parallel_tempering.cpp -Isource -o parallel_tempering.exe
+// ./parallel_tempering.exe
+/*
+ Same as read_network.cpp, but the networks with the target number of triangles
+ are drawn by parallel tempering over a ladder of betas, which does not get stuck
+ when the target is in a region of low entropy.
+
+ - REPLICAS is the number of betas (default 8), between 0 and BETA_MAX (default 2);
+ - THREADS is the number of threads (default: the number of cores);
+ - SEED is the seed of the random numbers (default 2).
+
+ Since the canonic distribution is uniform over the networks with a given number
+ of triangles, the networks can be taken from any beta.
+*/
+#include <vector>
+#include <iostream>
+
+#include "parallel_tempering.h"
+#include "io.h"
+
+std::vector<std::vector<unsigned int>> network_to_list(Network const& network) {
+    std::vector<std::vector<unsigned int>> result;
+
+    for (unsigned int node_i = 0; node_i < network.getN(); node_i++) {
+        for (unsigned int node_j : network.get_links(node_i))
+            result.push_back({node_i, node_j});
+    }
+    return result;
+};
+
+
+int main() {
+    char *env_replicas = getenv("REPLICAS");
+    unsigned int replicas = env_replicas == NULL ? 8 : (unsigned int)atoi(env_replicas);
+
+    char *env_beta_max = getenv("BETA_MAX");
+    double beta_max = env_beta_max == NULL ? 2 : atof(env_beta_max);
+
+    char *env_threads = getenv("THREADS");
+    unsigned int threads = env_threads == NULL ? parallel::threads() : (unsigned int)atoi(env_threads);
+
+    char *env_seed = getenv("SEED");
+    unsigned int seed = env_seed == NULL ? 2 : (unsigned int)atoi(env_seed);
+
+    Network network("./examples/input_network.dat");
+
+    unsigned int target_triangles = network.get_triangles()/2;
+    unsigned int target_networks = 10;
+    std::cout << "triangles: " << network.get_triangles() << std::endl;
+    std::cout << "target triangles: " << target_triangles << std::endl;
+
+    std::vector<double> betas(replicas);
+    for (unsigned int i = 0; i < replicas; i++)
+        betas[i] = beta_max*i/(replicas - 1);
+    ParallelTempering sampler(network, betas, 0, network.get_triangles(), seed);
+
+    // warm up, tuning the ladder
+    std::cout << "warm-up started" << std::endl;
+    sampler.sample(100000, 100, 50, threads);
+    std::cout << "warm-up finished" << std::endl;
+
+    // output networks
+    unsigned int found_networks = 0;
+    while (found_networks < target_networks) {
+        sampler.sample(100, 100, 0, threads);
+        for (unsigned int i = 0; i < replicas and found_networks < target_networks; i++) {
+            if (sampler.get_network(i).get_triangles() == target_triangles) {
+                found_networks++;
+                std::string file_name = format("./output/network_%d.dat", found_networks);
+                io::save(network_to_list(sampler.get_network(i)), file_name);
+            }
+        }
+    }
+
+    for (unsigned int i = 0; i < replicas; i++) {
+        Histogram<unsigned int> const& histogram = sampler.get_histogram(i);
+        double mean = 0;
+        for (unsigned int bin = 0; bin <= histogram.bins(); bin++)
+            mean += histogram.value(bin)*histogram[bin];
+        std::cout << "beta " << sampler.get_beta(i) << ": <triangles> = " << mean/histogram.count();
+        if (i + 1 < replicas)
+            std::cout << ", swap acceptance " << sampler.swap_acceptance(i);
+        std::cout << std::endl;
+    }
+    std::cout << "round-trips per second: " << sampler.round_trips_per_second()
+              << " (" << sampler.get_round_trips() << " round-trips)" << std::endl;
+    return 0;
+}
@@ -1,5 +1,5 @@
 // git@github.com:SamplingConstrainedNetworks/code.git
-// g++ -std=c++11 examples/read_network.cpp -Isource -o read_network.exe
+// g++ -std=c++11 -pthread examples/read_network.cpp -Isource -o read_network.exe
 // ./read_network.exe
 #include <vector>
 #include <iostream>
@@ -22,8 +22,8 @@ std::vector<std::vector<unsigned int>> network_to_list(Network const& network) {
 int main() {
     // the network to load
     Network network("./examples/input_network.dat");
-
-    Histogram<unsigned int> histogram(0, network.get_triangles(), network.get_triangles());
+    std::cout << "read " << network.get_parse_statistics().edges << " links at "
+              << network.get_parse_statistics().megabytes_per_second() << " MB/s" << std::endl;
 
     Random rng(2);  // the number is the seed
 
@@ -32,28 +32,27 @@ int main() {
     std::cout << "triangles: " << network.get_triangles() << std::endl;
     std::cout << "target triangles: " << target_triangles << std::endl;
 
+    // the walk is restricted to a window of triangles around the target
+    unsigned int window = 2;
+    unsigned int lower = target_triangles > window ? target_triangles - window : 0;
+    Histogram<unsigned int> histogram(lower, target_triangles + window, target_triangles + window - lower);
+
     // this is the sampler: how we move in the triangle space
     // this sampler preserves the degree sequence because proposals preserve the degree sequence (uses FixedDegreeProposer)
-    double beta = 1.0;
-    CanonicSampler sampler(rng, histogram, network, beta);
+    WindowSampler sampler(rng, histogram, network);
 
-    // warm up
+    // the entropy of the window makes every number of triangles in it equally likely
     std::cout << "warm-up started" << std::endl;
-    for (unsigned int step = 0; step < 1000; step++)
-        sampler.markov_step();
+    sampler.estimate_entropy(1e-3);
     std::cout << "warm-up finished" << std::endl;
 
-    // output networks
+    // output networks with target_triangles, at least 100 steps apart
     unsigned int found_networks = 0;
-    while (found_networks < target_networks) {
-        sampler.markov_step();
-        if (network.get_triangles() > target_triangles - 1 and network.get_triangles() < target_triangles + 1) {
-            // network with target_triangles found. Output it to a file
-            found_networks++;
-
-            std::string file_name = format("./output/network_%d.dat", found_networks);
-            io::save(network_to_list(network), file_name);
-        };
-    };
+    sampler.set_target(target_triangles, target_triangles);
+    sampler.sample(target_networks, 100, [&found_networks](Network const& sample) {
+        found_networks++;
+        std::string file_name = format("./output/network_%d.dat", found_networks);
+        io::save(network_to_list(sample), file_name);
+    });
     return 0;
 }
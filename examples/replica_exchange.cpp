@@ -0,0 +1,48 @@
+/*
+ This code computes the same entropy as entropy.cpp using replica-exchange
+ Wang-Landau: the range of triangles is split in overlapping windows, each
+ sampled by its own walkers in parallel, and neighbouring windows exchange
+ their networks.
+
+ - The network size is 4*BLOCKS;
+ - WINDOWS is the number of windows (default 4);
+ - WALKERS is the number of walkers per window (default 1);
+ - THREADS is the number of threads (default: all cores).
+
+ The output has the format of the entropy outputted by entropy.cpp.
+*/
+
+#include "replica_exchange.h"
+
+int main() {
+    char *env_blocks = getenv("BLOCKS");
+    if (env_blocks == NULL) {std::cout << "BLOCKS not defined" << std::endl; exit(1);}
+    unsigned int blocks = (unsigned int)atoi(env_blocks);
+
+    char *env_windows = getenv("WINDOWS");
+    unsigned int windows = env_windows == NULL ? 4 : (unsigned int)atoi(env_windows);
+
+    char *env_walkers = getenv("WALKERS");
+    unsigned int walkers = env_walkers == NULL ? 1 : (unsigned int)atoi(env_walkers);
+
+    char *env_threads = getenv("THREADS");
+    unsigned int threads = env_threads == NULL ? parallel::threads() : (unsigned int)atoi(env_threads);
+
+    unsigned int total_wl_steps = 15;
+
+    FixedDegreeNetwork network(3, blocks);
+
+    ReplicaExchangeWangLandau sampler(network, 0, network.get_triangles(), windows, 0.75, walkers);
+    for (unsigned int window = 0; window < windows; window++)
+        std::cout << "window " << window << ": [" << sampler.get_window_lower(window) << ", "
+                  << sampler.get_window_upper(window) << "]" << std::endl;
+
+    sampler.sample(total_wl_steps, 0.8, 1000, threads);
+
+    for (unsigned int window = 0; window + 1 < windows; window++)
+        std::cout << "exchange acceptance " << window << "-" << window + 1 << ": "
+                  << sampler.exchange_acceptance(window) << std::endl;
+
+    sampler.export_entropy(format("rewl_B%d_W%d.dat", blocks, windows));
+    return 0;
+}
@@ -0,0 +1,44 @@
+/*
+ This code computes the canonic curves of entropies outputted by the other
+ examples (e.g. fig1_results/entropy_B4_S4.dat of entropy.cpp), see source/reweighting.h:
+
+     ./reweighting <entropy file> [<entropy file> ...]
+
+ - BETA_MIN and BETA_MAX are the range of betas (default: -2 and 2);
+ - BETAS is the number of betas in the range (default: 1000);
+ - THREADS is the number of threads (default: the number of cores).
+
+ For each file, it writes <file>.canonic with the rows `beta log(Z) <t> var(t)`, where
+ Z(beta) = sum_t exp(beta*t + S(t)) and <t> is the curve c(beta) of figure 1a) of the paper.
+*/
+
+#include "reweighting.h"
+
+#include <chrono>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {std::cout << "usage: " << argv[0] << " <entropy file> [<entropy file> ...]" << std::endl; exit(1);}
+
+    char *env_beta_min = getenv("BETA_MIN");
+    double beta_min = env_beta_min == NULL ? -2 : atof(env_beta_min);
+
+    char *env_beta_max = getenv("BETA_MAX");
+    double beta_max = env_beta_max == NULL ? 2 : atof(env_beta_max);
+
+    char *env_betas = getenv("BETAS");
+    unsigned int betas = env_betas == NULL ? 1000 : (unsigned int)atoi(env_betas);
+
+    char *env_threads = getenv("THREADS");
+    unsigned int threads = env_threads == NULL ? parallel::threads() : (unsigned int)atoi(env_threads);
+
+    for (int file = 1; file < argc; file++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        reweighting::CanonicReweighting reweighting(reweighting::load_entropy(argv[file]));
+        reweighting::CanonicCurves curves(reweighting.curves(reweighting::linspace(beta_min, beta_max, betas),
+                                                              threads));
+        curves.export_curves(std::string(argv[file]) + ".canonic");
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << argv[file] << ": " << betas << " betas in " << seconds << " s" << std::endl;
+    }
+    return 0;
+}
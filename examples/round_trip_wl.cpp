@@ -4,6 +4,13 @@
 
  - The network size is 4*BLOCKS;
  - Increasing ROUND_TRIPS improves the convergence of Wang-Landau;
+ - WL_STEPS is the number of WL steps (halvings of f), 15 by default;
+ - If CHECKPOINT is defined, the state of the simulation is saved to that file every
+   5 minutes and, if the file exists, the simulation continues from it.
+ - If METRICS is defined and the code is compiled with -DTRIANGLES_METRICS, the
+   metrics of the sampler (see source/metrics.h), including the distributions of
+   round-trip and tunnelling times, are exported to METRICS.json and METRICS.csv
+   every 10 seconds and at the end.
 
  Each run of this code is a single point and respective error bars on figure 2.
  The curve in the figure is constructed by picking the average round-trip of the last WL step of each run and plot it
@@ -21,7 +28,8 @@ int main() {
     if (env_round_trips == NULL) {std::cout << "ROUND_TRIPS not defined" << std::endl; exit(1);}
     unsigned int round_trips = (unsigned int)atoi(env_round_trips);
 
-    unsigned int total_wl_steps = 15;
+    char *env_wl_steps = getenv("WL_STEPS");
+    unsigned int total_wl_steps = env_wl_steps == NULL ? 15 : (unsigned int)atoi(env_wl_steps);
 
     FixedDegreeNetwork network(3, blocks);
 
@@ -30,32 +38,40 @@ int main() {
 
     WangLandauSampler sampler(rng, histogram, network);
 
-    // warm up
-    while (network.get_triangles() != 0)
-        sampler.markov_step();
+    char *env_checkpoint = getenv("CHECKPOINT");
+    if (env_checkpoint != NULL and std::ifstream(env_checkpoint).good())
+        sampler.load_checkpoint(env_checkpoint);
+    else {
+        // warm up
+        while (network.get_triangles() != 0)
+            sampler.markov_step();
+    }
+    if (env_checkpoint != NULL)
+        sampler.set_checkpoint(env_checkpoint, 300);
+
+    char *env_metrics = getenv("METRICS");
+    if (env_metrics != NULL)
+        sampler.get_metrics().set_export(env_metrics, 10);
 
     std::vector<std::vector<double> > result;
 
-    for (unsigned int step = 0; step < total_wl_steps; step++) {
-        histogram.reset();
+    while (sampler.get_wl_step() < total_wl_steps) {
+        if (sampler.get_round_trip() == 0)
+            histogram.reset();
 
-        double mean_round_trip = 0;
-        double std_round_trip = 0;
-        for (unsigned int round_trip = 0; round_trip < round_trips; round_trip++) {
-            unsigned int previous_count = histogram.count();
+        // the statistics of the round-trip times are kept (and checkpointed) by the sampler
+        while (sampler.get_round_trip() < round_trips) {
             sampler.perform_round_trip();
-            unsigned int round_trip_time = histogram.count() - previous_count;
-
-            // update formula: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Online_algorithm
-            int n = round_trip + 1;
-            double delta = round_trip_time - mean_round_trip;
-            mean_round_trip += delta/n;
-            std_round_trip += delta*(round_trip_time - mean_round_trip);
+            sampler.checkpoint_if_due();
         }
+        std::cout << "w-l step " << sampler.get_wl_step() + 1 << ": round-trip time "
+                  << sampler.get_mean_round_trip() << " +- " << sqrt(sampler.get_variance_round_trip()) << std::endl;
         sampler.wang_landau_step();
 
         sampler.export_entropy(format("wl_B%d_S%d.dat", blocks, round_trips));
         histogram.export_histogram(format("results/histogram_wl_B%d_S%d.dat", blocks, round_trips));
     }
+    if (env_metrics != NULL)
+        sampler.export_metrics(env_metrics);
     return 0;
 }
@@ -5,4 +5,4 @@ export METHOD=CanonicSampling
 export BLOCKS=4
 
 ### compile and execute
-g++ -std=c++11 examples/generic.cpp -Isource -o pp && ./pp
+g++ -std=c++11 -pthread examples/generic.cpp -Isource -o pp && ./pp
@@ -0,0 +1,95 @@
+#ifndef triangles_acceptance_h
+#define triangles_acceptance_h
+
+#include <vector>
+#include <math.h>
+
+#include "random.h"
+
+
+//! Acceptance rules of the samplers (see `MarkovChainSampler`). Each one has
+//! - `uses_delta`: whether it depends on the number of triangles of the proposed
+//!   network (if not, proposals are applied without computing it);
+//! - `accept(rng, old_triangles, new_triangles)`: whether to apply a proposal.
+//! Moves that do not decrease the weight are accepted without drawing a random number.
+namespace acceptance {
+
+    //! Metropolis test of a move that multiplies the weight by exp(log_ratio),
+    //! compared in log-space. Used by the samplers and by the exchanges of replicas.
+    inline bool metropolis(Random & rng, double log_ratio) {
+        return log_ratio >= 0 or log(rng.R()) <= log_ratio;
+    }
+}
+
+
+//! Accepts every proposal: samples networks uniformly.
+struct UniformAcceptance {
+    static const bool uses_delta = false;
+
+    inline bool accept(Random &, unsigned int, unsigned int) const {return true;}
+};
+
+
+//! Metropolis acceptance of the canonic distribution, exp(beta*triangles).
+//! The change of triangles of a move is a small integer, so the probabilities
+//! exp(-|beta*delta|) of the moves that decrease the weight are cached in a
+//! table indexed by |delta|, which grows when a larger |delta| shows up.
+class CanonicAcceptance {
+protected:
+    double beta;
+    std::vector<double> table;  // table[|delta|] == exp(-|beta|*|delta|)
+
+    void grow(unsigned int size) {
+        for (unsigned int delta = (unsigned int)table.size(); delta < size; delta++)
+            table.push_back(exp(-fabs(beta)*delta));
+    }
+public:
+    static const bool uses_delta = true;
+
+    CanonicAcceptance(double beta=0) : beta(beta) {grow(16);}
+
+    inline double get_beta() const {return beta;}
+    void set_beta(double new_beta) {
+        beta = new_beta;
+        table.clear();
+        grow(16);
+    }
+
+    inline bool accept(Random & rng, unsigned int old_triangles, unsigned int new_triangles) {
+        int delta = (int)new_triangles - (int)old_triangles;
+        if (beta*delta >= 0)
+            return true;
+        unsigned int size = (unsigned int)(delta < 0 ? -delta : delta);
+        if (size >= table.size())
+            grow(2*size);
+        return rng.R() <= table[size];
+    }
+};
+
+
+//! Metropolis acceptance with weights exp(-S(t)) on the bins of a histogram, as
+//! used by Wang-Landau (where S is updated) and multicanonical sampling (where
+//! it is fixed); S changes between steps, so it is compared in log-space.
+//! Moves out of the range of the histogram are always rejected.
+//! It refers to the histogram and to the entropy, which belong to the sampler.
+template <class HistogramType>
+struct EntropyAcceptance {
+    static const bool uses_delta = true;
+    HistogramType const* histogram;
+    std::vector<double> const* entropy;
+
+    EntropyAcceptance(HistogramType const& histogram, std::vector<double> const& entropy) :
+    histogram(&histogram), entropy(&entropy) {}
+
+    inline bool in_range(unsigned int triangles) const {
+        return triangles >= histogram->value(0) and triangles <= histogram->value(histogram->bins());
+    }
+
+    inline bool accept(Random & rng, unsigned int old_triangles, unsigned int new_triangles) const {
+        return in_range(new_triangles) and
+               acceptance::metropolis(rng, (*entropy)[histogram->bin(old_triangles)] -
+                                           (*entropy)[histogram->bin(new_triangles)]);
+    }
+};
+
+#endif
@@ -0,0 +1,280 @@
+#ifndef triangles_enumeration_h
+#define triangles_enumeration_h
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+#include "network.h"
+#include "io.h"
+#include "parallel.h"
+
+
+//! Exact density of states of small networks: the number of simple graphs with
+//! a given degree sequence, per number of triangles. The graphs are of labelled
+//! nodes, as sampled by the Markov chain, so its log is the entropy that the
+//! samplers estimate (see `export_entropy`).
+//!
+//! The graphs are generated in order, one node at a time: a node takes its links
+//! to the nodes that follow it, and its links to the nodes before it are already
+//! decided. The nodes still to be processed are grouped in cells of nodes with
+//! the same degree left and the same links to processed nodes; swapping two nodes
+//! of a cell maps the completions of the graph one to one, with the same number of
+//! triangles. So a node takes k links into a cell of size n only to its first k
+//! nodes, counted binomial(n, k) times, which enumerates each class of graphs once
+//! instead of once per labelling. Choices after which the degrees left cannot be
+//! completed to a simple graph (by the Erdős–Gallai theorem) are pruned.
+//! Counts are `long double`s: they overflow 64 bits already for 20 nodes.
+class ExactEnumerator {
+public:
+    //! the maximum number of nodes, the bits of a link mask.
+    static unsigned int max_nodes() {return 64;}
+protected:
+    typedef unsigned long long Mask;
+
+    //! a partial graph: the nodes before `first` in `order` are processed.
+    struct State {
+        Mask links[64];               // the decided links of each node
+        unsigned char left[64];       // degree left of each node
+        unsigned char order[64];      // the nodes, processed first and then cell by cell
+        bool cell_start[65];          // whether a position of `order` starts a cell
+        unsigned char first;          // the first node to process in `order`
+        unsigned int triangles;       // of the decided links
+        long double weight;           // the graphs that this state stands for
+    };
+
+    std::vector<unsigned int> degrees;
+    std::vector<long double> counts;  // the number of graphs per number of triangles
+    std::vector<std::vector<long double> > binomials;
+    unsigned long long states;        // partial graphs visited by the last `enumerate`
+
+    //! whether the degrees left of the nodes still to process are those of a simple graph.
+    bool is_graphical(State const& state) const {
+        unsigned int nodes = (unsigned int)degrees.size() - state.first;
+        unsigned int sorted[64];
+        unsigned int sum = 0;
+        for (unsigned int i = 0; i < nodes; i++) {
+            sorted[i] = state.left[state.order[state.first + i]];
+            sum += sorted[i];
+        }
+        if (sum % 2)
+            return false;
+        std::sort(sorted, sorted + nodes, std::greater<unsigned int>());
+        unsigned int lhs = 0;
+        for (unsigned int k = 1; k <= nodes and sorted[k - 1] > 0; k++) {
+            lhs += sorted[k - 1];
+            if (k < nodes and sorted[k] == sorted[k - 1])
+                continue;  // the inequality of the last k of a run of equal degrees is the strongest
+            unsigned int rhs = k*(k - 1);
+            for (unsigned int i = k; i < nodes; i++)
+                rhs += std::min(sorted[i], k);
+            if (lhs > rhs)
+                return false;
+        }
+        return true;
+    }
+
+    //! links the next node of `state` to the chosen nodes: `chosen[c]` of the cell
+    //! starting at position `starts[c]`, for every cell until `cells`.
+    State linked(State const& state, unsigned char const* starts, unsigned char const* chosen,
+                 unsigned int cells, long double weight) const {
+        State result(state);
+        unsigned int node = state.order[state.first];
+        result.first++;
+        result.cell_start[result.first] = true;
+        result.weight = weight;
+        for (unsigned int c = 0; c < cells; c++) {
+            for (unsigned int position = starts[c]; position < starts[c] + chosen[c]; position++) {
+                unsigned int other = state.order[position];
+                result.triangles += __builtin_popcountll(state.links[node] & state.links[other]);
+                result.links[node] |= Mask(1) << other;
+                result.links[other] |= Mask(1) << node;
+                result.left[other]--;
+            }
+            result.cell_start[starts[c] + chosen[c]] = true;
+        }
+        result.left[node] = 0;
+        return result;
+    }
+
+    //! calls `visit` with every state that follows `state` by linking its next node;
+    //! `c` is the cell being chosen into and `links` the links still to choose.
+    template <class Visit>
+    void choose(State const& state, unsigned char* starts, unsigned char* chosen, unsigned int c,
+                unsigned int position, unsigned int links, long double weight, Visit & visit) const {
+        unsigned int nodes = (unsigned int)degrees.size();
+        if (links == 0) {
+            State next(linked(state, starts, chosen, c, weight));
+            if (is_graphical(next))
+                visit(next);
+            return;
+        }
+        // whether the cells from `position` have enough nodes to take the links, and the first of them that can
+        unsigned int capacity = 0;
+        for (unsigned int p = position; p < nodes; p++)
+            capacity += state.left[state.order[p]] > 0;
+        if (capacity < links)
+            return;
+        while (state.left[state.order[position]] == 0)
+            position++;
+
+        unsigned int end = position + 1;
+        while (end < nodes and not state.cell_start[end])
+            end++;
+        unsigned int size = end - position;
+        starts[c] = (unsigned char)position;
+        for (unsigned int k = std::min(size, links) + 1; k-- > 0;) {
+            chosen[c] = (unsigned char)k;
+            choose(state, starts, chosen, c + 1, end, links - k, weight*binomials[size][k], visit);
+        }
+    }
+
+    //! calls `visit` with every state that follows `state`.
+    template <class Visit>
+    void expand(State const& state, Visit & visit) const {
+        // the next node leaves its cell
+        State current(state);
+        current.cell_start[current.first + 1] = true;
+        unsigned char starts[64], chosen[64];
+        choose(current, starts, chosen, 0, current.first + 1, current.left[current.order[current.first]],
+               current.weight, visit);
+    }
+
+    //! adds the graphs of every completion of `state` to `result`.
+    void search(State const& state, std::vector<long double> & result, unsigned long long & visited) const {
+        visited++;
+        if (state.first == degrees.size()) {
+            result[state.triangles] += state.weight;
+            return;
+        }
+        auto visit = [&](State const& next) {search(next, result, visited);};
+        expand(state, visit);
+    }
+
+    State initial_state() const {
+        State state;
+        unsigned int nodes = (unsigned int)degrees.size();
+        std::vector<unsigned int> order(nodes);
+        for (unsigned int node = 0; node < nodes; node++)
+            order[node] = node;
+        // the cells of the same degree, the highest first
+        std::stable_sort(order.begin(), order.end(), [this](unsigned int i, unsigned int j) {
+            return degrees[i] > degrees[j];
+        });
+        for (unsigned int position = 0; position < nodes; position++) {
+            unsigned int node = order[position];
+            state.links[node] = 0;
+            state.left[node] = (unsigned char)degrees[node];
+            state.order[position] = (unsigned char)node;
+            state.cell_start[position] = position == 0 or degrees[order[position - 1]] != degrees[node];
+        }
+        state.cell_start[nodes] = true;
+        state.first = 0;
+        state.triangles = 0;
+        state.weight = 1;
+        return state;
+    }
+public:
+    ExactEnumerator(std::vector<unsigned int> const& degrees) : degrees(degrees), states(0) {
+        if (degrees.size() > max_nodes()) {
+            std::cout << "the enumeration is limited to " << max_nodes() << " nodes" << std::endl;
+            exit(1);
+        }
+        for (unsigned int degree : degrees)
+            if (degree >= degrees.size()) {
+                std::cout << "a degree " << degree << " is too large for " << degrees.size() << " nodes" << std::endl;
+                exit(1);
+            }
+        binomials.resize(degrees.size() + 1);
+        for (unsigned int n = 0; n <= degrees.size(); n++) {
+            binomials[n].assign(n + 1, 1);
+            for (unsigned int k = 1; k < n; k++)
+                binomials[n][k] = binomials[n - 1][k - 1] + binomials[n - 1][k];
+        }
+    }
+
+    //! the degree sequence of `network`.
+    ExactEnumerator(Network const& network) : ExactEnumerator(degree_sequence(network)) {}
+
+    static std::vector<unsigned int> degree_sequence(Network const& network) {
+        std::vector<unsigned int> result(network.getN());
+        for (unsigned int node = 0; node < network.getN(); node++)
+            result[node] = (unsigned int)network.get_links(node).size();
+        return result;
+    }
+
+    //! Counts the graphs: the first levels of the search are expanded into at
+    //! least `tasks_per_thread` tasks per thread, which are searched in parallel.
+    void enumerate(unsigned int threads=parallel::threads(), unsigned int tasks_per_thread=64) {
+        unsigned int max_triangles = 0;
+        for (unsigned int degree : degrees)
+            max_triangles += degree*(degree - 1)/2;  // wedges
+        counts.assign(max_triangles/3 + 1, 0);
+        states = 0;
+
+        std::vector<State> tasks(1, initial_state());
+        if (not is_graphical(tasks[0]))
+            return;
+        while (not tasks.empty() and tasks.size() < tasks_per_thread*threads) {
+            std::vector<State> next;
+            auto visit = [&](State const& state) {
+                if (state.first == degrees.size())
+                    counts[state.triangles] += state.weight;
+                else
+                    next.push_back(state);
+            };
+            for (State const& state : tasks)
+                expand(state, visit);
+            states += tasks.size();
+            tasks.swap(next);
+        }
+
+        std::vector<std::vector<long double> > results(tasks.size());
+        std::vector<unsigned long long> visited(tasks.size(), 0);
+        parallel::for_each((unsigned int)tasks.size(), [&](unsigned int task) {
+            results[task].assign(counts.size(), 0);
+            search(tasks[task], results[task], visited[task]);
+        }, threads);
+        for (unsigned int task = 0; task < tasks.size(); task++) {
+            for (unsigned int t = 0; t < counts.size(); t++)
+                counts[t] += results[task][t];
+            states += visited[task];
+        }
+    }
+
+    inline std::vector<unsigned int> const& get_degrees() const {return degrees;}
+    //! the number of graphs per number of triangles, after `enumerate`.
+    inline std::vector<long double> const& get_counts() const {return counts;}
+    inline unsigned long long get_states() const {return states;}
+
+    //! the number of graphs.
+    long double total() const {
+        long double result = 0;
+        for (long double count : counts)
+            result += count;
+        return result;
+    }
+
+    //! the entropy normalized to \sum(exp(S)) == 1, NAN where there are no graphs.
+    std::vector<double> entropy() const {
+        long double graphs = total();
+        std::vector<double> result(counts.size(), NAN);
+        for (unsigned int t = 0; t < counts.size(); t++)
+            if (counts[t] > 0)
+                result[t] = (double)logl(counts[t]/graphs);
+        return result;
+    }
+
+    //! exports the entropy in the format of `WangLandauSampler::export_entropy`, with bins of one triangle.
+    void export_entropy(std::string file_name) const {
+        std::vector<double> S(entropy());
+        std::vector<std::vector<double> > data;
+        for (unsigned int t = 0; t < S.size(); t++)
+            if (not std::isnan(S[t]))
+                data.push_back({(double)t, S[t]});
+        io::save(data, file_name);
+    }
+};
+
+#endif
@@ -5,12 +5,37 @@
 #include <assert.h>
 #include <string>
 #include <math.h>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
 
 #include "io.h"
 
+//! Binning policies of `Histogram`: bins are linear on `v(value)`, and `iv` is the inverse of `v`.
+struct LinearBinning {
+    template <typename T> static inline T v(T value) {return value;}
+    template <typename T> static inline T iv(T value) {return value;}
+};
+
+//! logarithmic bins, for positive values spanning several orders of magnitude.
+//! The bounds are stored as logs of type `T`, so `T` must be a floating-point
+//! type: with integers, the logs and the values of the bins would be truncated.
+struct LogarithmicBinning {
+    template <typename T> static inline T v(T value) {
+        static_assert(std::is_floating_point<T>::value, "LogarithmicBinning needs a floating-point T");
+        return log(value);
+    }
+    template <typename T> static inline T iv(T value) {
+        static_assert(std::is_floating_point<T>::value, "LogarithmicBinning needs a floating-point T");
+        return exp(value);
+    }
+};
+
+
 //! This is an implementation of an Histogram.
 //! Check its tests on test/test_histogram.h to see how it works in practice.
-template <typename T>
+//! The binning is a policy (e.g. `LinearBinning`), resolved at compile time.
+template <typename T, class Binning=LinearBinning>
 class Histogram {
 protected:
     T _lowerBound;
@@ -20,12 +45,11 @@ protected:
     unsigned int _count; // number of measured samples
     std::vector<unsigned int> _histogram;  // histogram of samples over bins
 
-    // these two can be overwritten in a subclass to use non-linear binning
-    inline virtual T v(T value) const {
-        return value;
+    inline T v(T value) const {
+        return Binning::v(value);
     }
-    inline virtual T iv(T value) const {
-        return value;
+    inline T iv(T value) const {
+        return Binning::iv(value);
     }
 
 public:
@@ -72,17 +96,60 @@ public:
         return iv(_lowerBound + (_upperBound - _lowerBound)*bin/_bins);
     }
 
-    virtual void reset() {
+    void reset() {
         for (unsigned int bin = 0; bin <= _bins; bin++)
             _histogram[bin] = 0;
         _count = 0;
     }
 
-    virtual void add(T value) {
+    inline void add(T value) {
         _histogram[bin(value)]++;
         _count++;
     }
 
+    //! adds the counts of a histogram with the same bins.
+    void merge(Histogram const& other) {
+        assert(other._histogram.size() == _histogram.size());
+        for (unsigned int bin = 0; bin <= _bins; bin++)
+            _histogram[bin] += other._histogram[bin];
+        _count += other._count;
+    }
+
+    //! Flatness criterion: whether every bin in `bins` (a mask, e.g. of the bins
+    //! visited so far) has at least `flatness` times the average count over them.
+    //! With an empty mask, the bins with a non-zero count are used.
+    bool is_flat(double flatness, std::vector<bool> const& bins=std::vector<bool>()) const {
+        assert(bins.empty() or bins.size() == _histogram.size());
+        unsigned int minimum = std::numeric_limits<unsigned int>::max();
+        double total = 0;
+        unsigned int used_bins = 0;
+        for (unsigned int bin = 0; bin <= _bins; bin++) {
+            if (bins.empty() ? _histogram[bin] == 0 : not bins[bin])
+                continue;
+            minimum = std::min(minimum, _histogram[bin]);
+            total += _histogram[bin];
+            used_bins++;
+        }
+        return used_bins > 0 and minimum > 0 and minimum >= flatness*total/used_bins;
+    }
+
+    //! writes the counts of the histogram (not its bounds).
+    void write(io::BinaryWriter & writer) const {
+        writer.write(_count);
+        writer.write(_histogram);
+    }
+
+    void read(io::BinaryReader & reader) {
+        _count = reader.read<unsigned int>();
+        std::vector<unsigned int> histogram(reader.read_vector<unsigned int>());
+        if (histogram.size() != _histogram.size()) {
+            std::cout << "histogram with " << histogram.size() - 1 << " bins, expected "
+                      << _bins << std::endl;
+            exit(1);
+        }
+        _histogram = histogram;
+    }
+
     void print() const {
         unsigned int sum = 0;
         for (unsigned int bin = 0; bin <= _bins; bin++) {
@@ -109,7 +176,7 @@ public:
         io::save(data, file_name);
     }
 
-    virtual void export_histogram(std::string file_name) const {
+    void export_histogram(std::string file_name) const {
         std::vector<std::vector<double> > data;
 
         for (unsigned int bin = 0; bin <= _bins; bin++)
@@ -0,0 +1,204 @@
+#ifndef triangles_intersection_h
+#define triangles_intersection_h
+
+#include <cstddef>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(TRIANGLES_NO_SIMD)
+#define TRIANGLES_X86_SIMD
+#include <immintrin.h>
+#endif
+
+
+//! Kernels that intersect two sorted arrays of distinct unsigned integers
+//! (e.g. the links of two nodes). `count` returns the size of the intersection
+//! and `intersect` also writes its elements to `out`, which must have room for
+//! min(size_a, size_b) elements. The vectorised kernels (SSE4.2 and AVX2) are
+//! picked at runtime from what the CPU supports; define `TRIANGLES_NO_SIMD` to
+//! always use the scalar ones.
+namespace intersection {
+
+    inline size_t count_scalar(unsigned int const* a, size_t size_a,
+                               unsigned int const* b, size_t size_b) {
+        size_t i = 0, j = 0, result = 0;
+        while (i < size_a and j < size_b) {
+            if (a[i] < b[j])
+                i++;
+            else if (b[j] < a[i])
+                j++;
+            else {
+                result++;
+                i++;
+                j++;
+            }
+        }
+        return result;
+    }
+
+    inline size_t intersect_scalar(unsigned int const* a, size_t size_a,
+                                   unsigned int const* b, size_t size_b, unsigned int* out) {
+        size_t i = 0, j = 0, result = 0;
+        while (i < size_a and j < size_b) {
+            if (a[i] < b[j])
+                i++;
+            else if (b[j] < a[i])
+                j++;
+            else {
+                out[result++] = a[i];
+                i++;
+                j++;
+            }
+        }
+        return result;
+    }
+
+#ifdef TRIANGLES_X86_SIMD
+    // Both kernels compare a block of `a` against all rotations of a block of
+    // `b` and then advance the block(s) with the smallest last element. Since
+    // elements are distinct, every common element matches exactly once.
+
+    //! lanes of the current block of `a` present in the block of `b`.
+    __attribute__((target("sse4.2")))
+    inline int match_sse42(unsigned int const* a, unsigned int const* b) {
+        __m128i block_a = _mm_loadu_si128((__m128i const*)a);
+        __m128i block_b = _mm_loadu_si128((__m128i const*)b);
+        __m128i match = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi32(block_a, block_b),
+                             _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(0, 3, 2, 1)))),
+                _mm_or_si128(_mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(1, 0, 3, 2))),
+                             _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(2, 1, 0, 3)))));
+        return _mm_movemask_ps(_mm_castsi128_ps(match));
+    }
+
+    __attribute__((target("avx2")))
+    inline int match_avx2(unsigned int const* a, unsigned int const* b) {
+        __m256i block_a = _mm256_loadu_si256((__m256i const*)a);
+        __m256i block_b = _mm256_loadu_si256((__m256i const*)b);
+        // rotations within each 128-bit half, then the same with the halves swapped
+        __m256i swapped_b = _mm256_permute2x128_si256(block_b, block_b, 1);
+        __m256i match = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi32(block_a, block_b),
+                                _mm256_cmpeq_epi32(block_a, _mm256_shuffle_epi32(block_b, _MM_SHUFFLE(0, 3, 2, 1)))),
+                _mm256_or_si256(_mm256_cmpeq_epi32(block_a, _mm256_shuffle_epi32(block_b, _MM_SHUFFLE(1, 0, 3, 2))),
+                                _mm256_cmpeq_epi32(block_a, _mm256_shuffle_epi32(block_b, _MM_SHUFFLE(2, 1, 0, 3)))));
+        match = _mm256_or_si256(match, _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi32(block_a, swapped_b),
+                                _mm256_cmpeq_epi32(block_a, _mm256_shuffle_epi32(swapped_b, _MM_SHUFFLE(0, 3, 2, 1)))),
+                _mm256_or_si256(_mm256_cmpeq_epi32(block_a, _mm256_shuffle_epi32(swapped_b, _MM_SHUFFLE(1, 0, 3, 2))),
+                                _mm256_cmpeq_epi32(block_a, _mm256_shuffle_epi32(swapped_b, _MM_SHUFFLE(2, 1, 0, 3))))));
+        return _mm256_movemask_ps(_mm256_castsi256_ps(match));
+    }
+
+    __attribute__((target("sse4.2,popcnt")))
+    inline size_t count_sse42(unsigned int const* a, size_t size_a,
+                              unsigned int const* b, size_t size_b) {
+        size_t i = 0, j = 0, result = 0;
+        while (i + 4 <= size_a and j + 4 <= size_b) {
+            result += __builtin_popcount(match_sse42(a + i, b + j));
+            unsigned int last_a = a[i + 3], last_b = b[j + 3];
+            if (last_a <= last_b)
+                i += 4;
+            if (last_b <= last_a)
+                j += 4;
+        }
+        return result + count_scalar(a + i, size_a - i, b + j, size_b - j);
+    }
+
+    __attribute__((target("sse4.2,popcnt")))
+    inline size_t intersect_sse42(unsigned int const* a, size_t size_a,
+                                  unsigned int const* b, size_t size_b, unsigned int* out) {
+        size_t i = 0, j = 0, result = 0;
+        while (i + 4 <= size_a and j + 4 <= size_b) {
+            for (int mask = match_sse42(a + i, b + j); mask; mask &= mask - 1)
+                out[result++] = a[i + __builtin_ctz(mask)];
+            unsigned int last_a = a[i + 3], last_b = b[j + 3];
+            if (last_a <= last_b)
+                i += 4;
+            if (last_b <= last_a)
+                j += 4;
+        }
+        return result + intersect_scalar(a + i, size_a - i, b + j, size_b - j, out + result);
+    }
+
+    __attribute__((target("avx2,popcnt")))
+    inline size_t count_avx2(unsigned int const* a, size_t size_a,
+                             unsigned int const* b, size_t size_b) {
+        size_t i = 0, j = 0, result = 0;
+        while (i + 8 <= size_a and j + 8 <= size_b) {
+            result += __builtin_popcount(match_avx2(a + i, b + j));
+            unsigned int last_a = a[i + 7], last_b = b[j + 7];
+            if (last_a <= last_b)
+                i += 8;
+            if (last_b <= last_a)
+                j += 8;
+        }
+        return result + count_sse42(a + i, size_a - i, b + j, size_b - j);
+    }
+
+    __attribute__((target("avx2,popcnt")))
+    inline size_t intersect_avx2(unsigned int const* a, size_t size_a,
+                                 unsigned int const* b, size_t size_b, unsigned int* out) {
+        size_t i = 0, j = 0, result = 0;
+        while (i + 8 <= size_a and j + 8 <= size_b) {
+            for (int mask = match_avx2(a + i, b + j); mask; mask &= mask - 1)
+                out[result++] = a[i + __builtin_ctz(mask)];
+            unsigned int last_a = a[i + 7], last_b = b[j + 7];
+            if (last_a <= last_b)
+                i += 8;
+            if (last_b <= last_a)
+                j += 8;
+        }
+        return result + intersect_sse42(a + i, size_a - i, b + j, size_b - j, out + result);
+    }
+#endif
+
+    typedef size_t (*CountKernel)(unsigned int const*, size_t, unsigned int const*, size_t);
+    typedef size_t (*IntersectKernel)(unsigned int const*, size_t, unsigned int const*, size_t, unsigned int*);
+
+    //! name of the kernels used by `count` and `intersect` on this CPU.
+    inline const char* kernel_name() {
+#ifdef TRIANGLES_X86_SIMD
+        if (__builtin_cpu_supports("avx2"))
+            return "avx2";
+        if (__builtin_cpu_supports("sse4.2"))
+            return "sse4.2";
+#endif
+        return "scalar";
+    }
+
+    inline CountKernel count_kernel() {
+        static const CountKernel kernel =
+#ifdef TRIANGLES_X86_SIMD
+                __builtin_cpu_supports("avx2") ? count_avx2 :
+                __builtin_cpu_supports("sse4.2") ? count_sse42 :
+#endif
+                count_scalar;
+        return kernel;
+    }
+
+    inline IntersectKernel intersect_kernel() {
+        static const IntersectKernel kernel =
+#ifdef TRIANGLES_X86_SIMD
+                __builtin_cpu_supports("avx2") ? intersect_avx2 :
+                __builtin_cpu_supports("sse4.2") ? intersect_sse42 :
+#endif
+                intersect_scalar;
+        return kernel;
+    }
+
+    //! Blocks are 4 elements wide, so shorter arrays go straight to the scalar kernel.
+    inline size_t count(unsigned int const* a, size_t size_a,
+                        unsigned int const* b, size_t size_b) {
+        if (size_a < 4 or size_b < 4)
+            return count_scalar(a, size_a, b, size_b);
+        return count_kernel()(a, size_a, b, size_b);
+    }
+
+    inline size_t intersect(unsigned int const* a, size_t size_a,
+                            unsigned int const* b, size_t size_b, unsigned int* out) {
+        if (size_a < 4 or size_b < 4)
+            return intersect_scalar(a, size_a, b, size_b, out);
+        return intersect_kernel()(a, size_a, b, size_b, out);
+    }
+}
+
+#endif
@@ -11,6 +11,15 @@
 #include <memory>    // for unique_ptr
 #include <iterator>  // for istream_iterator
 #include <limits>
+#include <cstdio>
+#include <chrono>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 
 //! splits a list of strings by the delimiter
@@ -122,6 +131,261 @@ namespace io {
 
         return data;
     }
+
+    //! Statistics of reading a file with `read_edges`.
+    struct ParseStatistics {
+        size_t bytes;
+        size_t lines;
+        size_t edges;
+        double seconds;
+
+        double megabytes_per_second() const {
+            return seconds > 0 ? bytes/1e6/seconds : 0;
+        }
+    };
+
+    //! Reads a list of links, calling `edge(node_i, node_j)` with the first two
+    //! columns of every line. Columns are separated by spaces, tabs or commas,
+    //! further columns are ignored and lines starting with '#' or '%' are
+    //! comments. The file is read in chunks and parsed without iostreams, so
+    //! memory does not grow with the size of the file.
+    template <typename Callback>
+    ParseStatistics read_edges(std::string file_name, Callback edge) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        ParseStatistics statistics = {0, 0, 0, 0};
+
+        FILE* file = fopen(file_name.c_str(), "rb");
+        if (file == NULL) {
+            std::cout << "file \"" << file_name << "\" not found" << std::endl;
+            exit(1);
+        }
+
+        const size_t chunk_size = 1 << 20;
+        std::vector<char> buffer(chunk_size + 1);
+        size_t pending = 0;  // bytes of an incomplete line at the start of the buffer
+        while (true) {
+            size_t read = fread(buffer.data() + pending, 1, buffer.size() - 1 - pending, file);
+            statistics.bytes += read;
+            size_t size = pending + read;
+            bool last_chunk = read == 0 or feof(file);
+            if (size == 0)
+                break;
+            if (last_chunk and buffer[size - 1] != '\n')
+                buffer[size++] = '\n';  // there is always room for it
+
+            char const* position = buffer.data();
+            char const* end = buffer.data() + size;
+            while (true) {
+                char const* line_end = (char const*)memchr(position, '\n', end - position);
+                if (line_end == NULL)
+                    break;
+                statistics.lines++;
+
+                unsigned int columns[2];
+                unsigned int column = 0;
+                char const* c = position;
+                while (c < line_end and (*c == ' ' or *c == '\t' or *c == '\r'))
+                    c++;
+                if (c < line_end and *c != '#' and *c != '%') {
+                    while (column < 2 and c < line_end) {
+                        if (*c < '0' or *c > '9') {
+                            std::cout << "file \"" << file_name << "\": invalid link in line "
+                                      << statistics.lines << std::endl;
+                            exit(1);
+                        }
+                        // the digits beyond the range of unsigned int stop accumulating, without overflowing
+                        unsigned long long value = 0;
+                        for (; c < line_end and *c >= '0' and *c <= '9'; c++)
+                            if (value <= std::numeric_limits<unsigned int>::max())
+                                value = value*10 + (*c - '0');
+                        if (value > std::numeric_limits<unsigned int>::max()) {
+                            std::cout << "file \"" << file_name << "\": invalid link in line "
+                                      << statistics.lines << std::endl;
+                            exit(1);
+                        }
+                        columns[column++] = (unsigned int)value;
+                        while (c < line_end and (*c == ' ' or *c == '\t' or *c == ',' or *c == '\r'))
+                            c++;
+                    }
+                    if (column < 2) {
+                        std::cout << "file \"" << file_name << "\": invalid link in line "
+                                  << statistics.lines << std::endl;
+                        exit(1);
+                    }
+                    edge(columns[0], columns[1]);
+                    statistics.edges++;
+                }
+                position = line_end + 1;
+            }
+
+            // move the incomplete line to the start of the buffer
+            if (last_chunk)
+                break;
+            pending = end - position;
+            memmove(buffer.data(), position, pending);
+            if (pending == buffer.size() - 1)
+                buffer.resize(2*buffer.size());  // a line longer than the buffer
+        }
+        fclose(file);
+
+        statistics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return statistics;
+    }
+
+    //! A file mapped in memory (read-only). Where `mmap` is not available, the
+    //! file is read to memory instead.
+    class MappedFile {
+        char const* _data;
+        size_t _size;
+        std::vector<char> buffer;  // only without mmap
+    public:
+        MappedFile(std::string file_name) : _data(NULL), _size(0) {
+#ifndef _WIN32
+            int descriptor = open(file_name.c_str(), O_RDONLY);
+            struct stat status;
+            if (descriptor < 0 or fstat(descriptor, &status) != 0) {
+                std::cout << "file \"" << file_name << "\" not found" << std::endl;
+                exit(1);
+            }
+            _size = (size_t)status.st_size;
+            if (_size > 0) {
+                void* address = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+                if (address == MAP_FAILED) {
+                    std::cout << "file \"" << file_name << "\" could not be mapped" << std::endl;
+                    exit(1);
+                }
+                _data = (char const*)address;
+            }
+            close(descriptor);
+#else
+            std::ifstream file(file_name.c_str(), std::ios::binary);
+            if (!file.is_open()) {
+                std::cout << "file \"" << file_name << "\" not found" << std::endl;
+                exit(1);
+            }
+            buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            _data = buffer.data();
+            _size = buffer.size();
+#endif
+        }
+
+        ~MappedFile() {
+#ifndef _WIN32
+            if (_data != NULL)
+                munmap((void*)_data, _size);
+#endif
+        }
+
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+
+        inline char const* data() const {return _data;}
+        inline size_t size() const {return _size;}
+    };
+
+    //! Writes values and arrays of trivially copyable types to a binary file.
+    //! Arrays start at multiples of 8 bytes, so that `BinaryReader` can
+    //! use them in place.
+    class BinaryWriter {
+        std::ofstream file;
+        std::string file_name;
+        size_t position;
+    public:
+        BinaryWriter(std::string file_name) : file_name(file_name), position(0) {
+            file.open(file_name.c_str(), std::ios::binary);
+            if (!file.is_open()) {
+                std::cout << "file \"" << file_name << "\" could not be opened" << std::endl;
+                exit(1);
+            }
+        }
+
+        void write_bytes(void const* data, size_t size) {
+            file.write((char const*)data, size);
+            position += size;
+        }
+
+        template <typename T>
+        void write(T const& value) {
+            write_bytes(&value, sizeof(T));
+        }
+
+        template <typename T>
+        void write(T const* data, size_t size) {
+            align();
+            write_bytes(data, size*sizeof(T));
+        }
+
+        template <typename T>
+        void write(std::vector<T> const& data) {
+            write((unsigned long long)data.size());
+            write(data.data(), data.size());
+        }
+
+        void align() {
+            const char zeros[8] = {0};
+            if (position % 8)
+                write_bytes(zeros, 8 - position % 8);
+        }
+
+        //! flushes and closes the file; exits if something could not be written.
+        void close() {
+            file.close();
+            if (file.fail()) {
+                std::cout << "file \"" << file_name << "\" could not be written" << std::endl;
+                exit(1);
+            }
+        }
+    };
+
+    //! Reads what `BinaryWriter` wrote from memory (e.g. a `MappedFile`).
+    //! Arrays are returned as pointers to that memory, without copies.
+    class BinaryReader {
+        char const* data;
+        size_t size;
+        size_t position;
+
+        //! exits unless `count` values of `bytes` bytes follow (without overflowing).
+        void require(size_t count, size_t bytes=1) const {
+            if (position > size or count > (size - position)/bytes) {
+                std::cout << "binary file is truncated" << std::endl;
+                exit(1);
+            }
+        }
+    public:
+        BinaryReader(char const* data, size_t size) : data(data), size(size), position(0) {}
+        BinaryReader(MappedFile const& file) : data(file.data()), size(file.size()), position(0) {}
+
+        template <typename T>
+        T read() {
+            T value;
+            require(sizeof(T));
+            memcpy(&value, data + position, sizeof(T));
+            position += sizeof(T);
+            return value;
+        }
+
+        template <typename T>
+        T const* read(size_t count) {
+            if (position % 8)
+                position += 8 - position % 8;
+            require(count, sizeof(T));
+            T const* result = (T const*)(data + position);
+            position += count*sizeof(T);
+            return result;
+        }
+
+        template <typename T>
+        std::vector<T> read_vector() {
+            size_t count = (size_t)read<unsigned long long>();
+            T const* values = read<T>(count);
+            return std::vector<T>(values, values + count);
+        }
+
+        //! returns whether the next bytes are `bytes`, without reading them.
+        bool starts_with(char const* bytes, size_t count) const {
+            return position + count <= size and memcmp(data + position, bytes, count) == 0;
+        }
+    };
 }
 
 #endif
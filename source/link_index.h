@@ -0,0 +1,162 @@
+#ifndef triangles_link_index_h
+#define triangles_link_index_h
+
+#include <assert.h>
+#include <vector>
+#include <utility>
+#include <iostream>
+
+#include "io.h"
+
+
+typedef std::pair<unsigned int, unsigned int> Link;
+
+
+//! Index of the links of a network, used to draw a random link in constant time.
+//! It is an array with every link once, in no particular order, and an
+//! open-addressing hash table (linear probing) from each link to its position
+//! in the array. Removing a link moves the last link of the array to its place.
+class LinkIndex {
+protected:
+    std::vector<Link> links;
+    std::vector<unsigned long long> keys;  // `empty_key()` on free slots
+    std::vector<unsigned int> positions;   // position in `links` of the link in each slot
+    unsigned int shift;                    // 64 - log2(number of slots)
+
+    static inline unsigned long long empty_key() {return ~0ULL;}
+
+    static inline unsigned long long key(unsigned int node_i, unsigned int node_j) {
+        if (node_i > node_j)
+            std::swap(node_i, node_j);
+        return ((unsigned long long)node_i << 32) | node_j;
+    }
+
+    inline size_t mask() const {return keys.size() - 1;}
+
+    //! Fibonacci hashing: the slot where the probing of `key` starts.
+    inline size_t home(unsigned long long key) const {
+        return (size_t)((key*0x9E3779B97F4A7C15ULL) >> shift);
+    }
+
+    //! slot of an existing key.
+    size_t find(unsigned long long key) const {
+        size_t slot = home(key);
+        while (keys[slot] != key) {
+            assert(keys[slot] != empty_key());  // link must exist
+            slot = (slot + 1) & mask();
+        }
+        return slot;
+    }
+
+    void place(unsigned long long key, unsigned int position) {
+        size_t slot = home(key);
+        while (keys[slot] != empty_key())
+            slot = (slot + 1) & mask();
+        keys[slot] = key;
+        positions[slot] = position;
+    }
+
+    //! rebuilds the hash table with at least `slots` slots (a power of 2).
+    void rehash(size_t slots) {
+        unsigned int log_slots = 4;
+        while (((size_t)1 << log_slots) < slots)
+            log_slots++;
+        shift = 64 - log_slots;
+        keys.assign((size_t)1 << log_slots, empty_key());
+        positions.assign((size_t)1 << log_slots, 0);
+        for (unsigned int position = 0; position < links.size(); position++)
+            place(key(links[position].first, links[position].second), position);
+    }
+public:
+    LinkIndex() {rehash(16);}
+
+    inline unsigned int size() const {return (unsigned int)links.size();}
+
+    inline Link const& operator[](unsigned int position) const {return links[position];}
+
+    void clear() {
+        links.clear();
+        rehash(16);
+    }
+
+    //! prepares the index to hold `count` links without growing.
+    void reserve(size_t count) {
+        links.reserve(count);
+        if (2*count > keys.size())
+            rehash(2*count);
+    }
+
+    void insert(unsigned int node_i, unsigned int node_j) {
+        // keep the table at most half full
+        if (2*(links.size() + 1) > keys.size())
+            rehash(2*keys.size());
+        place(key(node_i, node_j), (unsigned int)links.size());
+        links.push_back(Link(node_i, node_j));
+    }
+
+    void erase(unsigned int node_i, unsigned int node_j) {
+        size_t hole = find(key(node_i, node_j));
+        unsigned int position = positions[hole];
+
+        // backward-shift deletion: move back the following keys of the probe
+        // sequence that would not be found with a free slot at `hole`.
+        size_t slot = hole;
+        while (true) {
+            slot = (slot + 1) & mask();
+            if (keys[slot] == empty_key())
+                break;
+            if (((slot - home(keys[slot])) & mask()) >= ((slot - hole) & mask())) {
+                keys[hole] = keys[slot];
+                positions[hole] = positions[slot];
+                hole = slot;
+            }
+        }
+        keys[hole] = empty_key();
+
+        if (position != links.size() - 1) {
+            links[position] = links.back();
+            positions[find(key(links[position].first, links[position].second))] = position;
+        }
+        links.pop_back();
+    }
+
+    void write(io::BinaryWriter & writer) const {
+        writer.write(links);
+        writer.write(keys);
+        writer.write(positions);
+        writer.write(shift);
+    }
+
+    //! Reads an index written by `write`, and exits if it is not consistent:
+    //! a corrupt table would be probed out of bounds or forever.
+    void read(io::BinaryReader & reader) {
+        links = reader.read_vector<Link>();
+        keys = reader.read_vector<unsigned long long>();
+        positions = reader.read_vector<unsigned int>();
+        shift = reader.read<unsigned int>();
+
+        bool valid = keys.size() >= 16 and (keys.size() & mask()) == 0 and positions.size() == keys.size() and
+                     shift == 64 - (unsigned int)__builtin_ctzll(keys.size()) and 2*links.size() <= keys.size();
+        size_t used = 0;
+        for (size_t slot = 0; valid and slot < keys.size(); slot++)
+            if (keys[slot] != empty_key()) {
+                used++;
+                valid = positions[slot] < links.size() and
+                        keys[slot] == key(links[positions[slot]].first, links[positions[slot]].second);
+            }
+        // every link is found from its home slot
+        for (unsigned int position = 0; valid and position < links.size(); position++) {
+            unsigned long long link_key = key(links[position].first, links[position].second);
+            size_t slot = home(link_key);
+            while (keys[slot] != link_key and keys[slot] != empty_key())
+                slot = (slot + 1) & mask();
+            valid = keys[slot] == link_key and positions[slot] == position;
+        }
+        if (not valid or used != links.size()) {
+            std::cout << "binary file has an invalid link index" << std::endl;
+            exit(1);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef triangles_link_list_h
+#define triangles_link_list_h
+
+#include <vector>
+#include <algorithm>
+
+
+//! A list of the nodes linked to a node, stored as a sorted contiguous array.
+//! It implements the part of the interface of `std::set<unsigned int>` used by
+//! the network, but lookups are binary searches on contiguous memory and
+//! iterations do not chase pointers through the heap.
+class SortedLinkList {
+protected:
+    std::vector<unsigned int> nodes;  // sorted, without repetitions
+public:
+    typedef std::vector<unsigned int>::const_iterator const_iterator;
+    typedef const_iterator iterator;
+
+    SortedLinkList() {}
+
+    //! Constructs the list from any range of nodes (e.g. a `std::set<unsigned int>`).
+    template <class Iterator>
+    SortedLinkList(Iterator first, Iterator last) : nodes(first, last) {
+        if (not std::is_sorted(nodes.begin(), nodes.end()))
+            std::sort(nodes.begin(), nodes.end());
+        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+    }
+
+    inline const_iterator begin() const {return nodes.begin();}
+    inline const_iterator end() const {return nodes.end();}
+
+    inline size_t size() const {return nodes.size();}
+    inline bool empty() const {return nodes.empty();}
+
+    //! the `index`-th smallest node of the list.
+    inline unsigned int operator[](size_t index) const {return nodes[index];}
+
+    //! pointer to the sorted array of nodes.
+    inline unsigned int const* data() const {return nodes.data();}
+
+    //! returns 1 if `node` is in the list, 0 otherwise (as `std::set::count`).
+    inline size_t count(unsigned int node) const {
+        return std::binary_search(nodes.begin(), nodes.end(), node);
+    }
+
+    void insert(unsigned int node) {
+        std::vector<unsigned int>::iterator it = std::lower_bound(nodes.begin(), nodes.end(), node);
+        if (it == nodes.end() or *it != node)
+            nodes.insert(it, node);
+    }
+
+    void erase(unsigned int node) {
+        std::vector<unsigned int>::iterator it = std::lower_bound(nodes.begin(), nodes.end(), node);
+        if (it != nodes.end() and *it == node)
+            nodes.erase(it);
+    }
+
+    bool operator==(SortedLinkList const& other) const {return nodes == other.nodes;}
+    bool operator!=(SortedLinkList const& other) const {return nodes != other.nodes;}
+};
+
+#endif
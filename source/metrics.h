@@ -0,0 +1,309 @@
+#ifndef triangles_metrics_h
+#define triangles_metrics_h
+
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+
+//! Instrumentation of the samplers and proposers, compiled in with
+//! `-DTRIANGLES_METRICS`. Without it, `SamplerMetrics` and `ProposerMetrics`
+//! are empty classes whose methods do nothing, so the samplers call them
+//! unconditionally at no cost.
+#ifdef TRIANGLES_METRICS
+
+//! Distribution of a time in steps: count, mean, extremes and a histogram in
+//! powers of 2 (bucket k counts the times in [2^k, 2^(k+1)[).
+struct TimeDistribution {
+    unsigned long long count;
+    double sum;
+    unsigned long long min;
+    unsigned long long max;
+    std::vector<unsigned long long> buckets;
+
+    TimeDistribution() : count(0), sum(0), min(0), max(0), buckets(64, 0) {}
+
+    void add(unsigned long long steps) {
+        min = count == 0 ? steps : std::min(min, steps);
+        max = std::max(max, steps);
+        count++;
+        sum += steps;
+        unsigned int bucket = 0;
+        while (bucket < 63 and (steps >> (bucket + 1)) != 0)
+            bucket++;
+        buckets[bucket]++;
+    }
+
+    inline double mean() const {return count ? sum/count : 0;}
+
+    void write_json(std::ostream & os) const {
+        unsigned int used = (unsigned int)buckets.size();
+        while (used > 0 and buckets[used - 1] == 0)
+            used--;
+        os << "{\"count\": " << count << ", \"mean\": " << mean() << ", \"min\": " << min
+           << ", \"max\": " << max << ", \"log2_buckets\": [";
+        for (unsigned int bucket = 0; bucket < used; bucket++)
+            os << (bucket ? ", " : "") << buckets[bucket];
+        os << "]}";
+    }
+};
+
+
+//! Retries of the rejection loops of `FixedDegreeProposer`.
+class ProposerMetrics {
+protected:
+    unsigned long long proposals;
+    unsigned long long new_link_draws;  // draws of "C" in `random_new_link`
+    unsigned long long old_link_draws;  // draws of "D" in `old_link`
+public:
+    static const bool enabled = true;
+
+    ProposerMetrics() : proposals(0), new_link_draws(0), old_link_draws(0) {}
+
+    inline void proposal() {proposals++;}
+    inline void new_link_draw() {new_link_draws++;}
+    inline void old_link_draw() {old_link_draws++;}
+
+    inline unsigned long long get_proposals() const {return proposals;}
+    //! draws beyond the first one of each proposal.
+    inline unsigned long long new_link_retries() const {return new_link_draws - proposals;}
+    inline unsigned long long old_link_retries() const {return old_link_draws - proposals;}
+
+    void write_json(std::ostream & os) const {
+        os << "{\"proposals\": " << proposals << ", \"new_link_retries\": " << new_link_retries()
+           << ", \"old_link_retries\": " << old_link_retries() << "}";
+    }
+};
+
+
+//! Metrics of a `MarkovChainSampler`: steps per second, proposals and acceptances
+//! per number of triangles, round-trip and tunnelling times between the lowest and
+//! the highest bin (of the samplers with a histogram range), and the time split
+//! between the phases of a step. Reading the clock costs as much as a fraction of a
+//! step, so only one step in `timing_period()` is timed, and the periodic export
+//! (see `set_export`) checks the clock once in `export_period()` steps.
+class SamplerMetrics {
+public:
+    static const bool enabled = true;
+
+    enum Phase {PROPOSAL, TRIANGLES, ACCEPTANCE, APPLY, PHASES};
+
+    static char const* phase_name(unsigned int phase) {
+        static char const* names[PHASES] = {"proposal", "triangles", "acceptance", "apply"};
+        return names[phase];
+    }
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    unsigned long long steps;
+    std::vector<unsigned long long> proposed;  // per number of triangles before the step
+    std::vector<unsigned long long> accepted;
+    Clock::time_point start;
+
+    bool timing;                 // whether the current step is timed
+    Clock::time_point lap_time;
+    unsigned long long timed_steps;
+    double seconds[PHASES];
+
+    // round-trips: the walk looks for the highest bin after visiting the lowest, and vice versa
+    enum Seeking {NOTHING, TOP, BOTTOM};
+    Seeking seeking;
+    unsigned long long last_bottom;
+    unsigned long long last_top;
+    unsigned long long round_trip_start;
+    TimeDistribution round_trips;
+    TimeDistribution tunnelling;  // from the last visit of one end to the first of the other
+
+    std::string export_prefix;  // empty if not exported periodically
+    double export_interval;     // in seconds
+    Clock::time_point last_export;
+
+    static unsigned int timing_period() {return 256;}
+    static unsigned int export_period() {return 1 << 14;}
+public:
+    SamplerMetrics() {reset();}
+
+    void reset() {
+        steps = 0;
+        proposed.clear();
+        accepted.clear();
+        start = Clock::now();
+        timing = false;
+        timed_steps = 0;
+        for (unsigned int phase = 0; phase < PHASES; phase++)
+            seconds[phase] = 0;
+        seeking = NOTHING;
+        last_bottom = last_top = round_trip_start = 0;
+        round_trips = TimeDistribution();
+        tunnelling = TimeDistribution();
+    }
+
+    inline void begin_step() {
+        steps++;
+        timing = steps % timing_period() == 0;
+        if (timing)
+            lap_time = Clock::now();
+    }
+
+    //! the time since the previous lap (or the beginning of the step) was spent on `phase`.
+    inline void lap(Phase phase) {
+        if (timing) {
+            Clock::time_point now = Clock::now();
+            seconds[phase] += std::chrono::duration<double>(now - lap_time).count();
+            lap_time = now;
+        }
+    }
+
+    inline void end_step(unsigned int old_triangles, bool was_accepted) {
+        if (old_triangles >= proposed.size()) {
+            proposed.resize(2*old_triangles + 1, 0);
+            accepted.resize(2*old_triangles + 1, 0);
+        }
+        proposed[old_triangles]++;
+        accepted[old_triangles] += was_accepted;
+        timed_steps += timing;
+    }
+
+    //! the walk is at `bin` of a histogram whose highest bin is `last_bin`.
+    inline void visit_bin(unsigned int bin, unsigned int last_bin) {
+        if (bin == 0) {
+            if (seeking == BOTTOM) {
+                tunnelling.add(steps - last_top);
+                round_trips.add(steps - round_trip_start);
+            }
+            if (seeking != TOP)
+                round_trip_start = steps;
+            seeking = TOP;
+            last_bottom = steps;
+        }
+        else if (bin == last_bin) {
+            if (seeking == TOP) {
+                tunnelling.add(steps - last_bottom);
+                seeking = BOTTOM;
+            }
+            last_top = steps;
+        }
+    }
+
+    inline unsigned long long get_steps() const {return steps;}
+    inline TimeDistribution const& get_round_trips() const {return round_trips;}
+    inline TimeDistribution const& get_tunnelling() const {return tunnelling;}
+
+    double seconds_elapsed() const {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    double steps_per_second() const {
+        double elapsed = seconds_elapsed();
+        return elapsed > 0 ? steps/elapsed : 0;
+    }
+
+    //! fraction of accepted proposals from networks with `triangles` triangles.
+    double acceptance(unsigned int triangles) const {
+        return triangles < proposed.size() and proposed[triangles] ? accepted[triangles]*1./proposed[triangles] : 0;
+    }
+
+    //! estimate of the fraction of the time of a step spent on `phase`.
+    double time_fraction(unsigned int phase) const {
+        double total = 0;
+        for (unsigned int p = 0; p < PHASES; p++)
+            total += seconds[p];
+        return total > 0 ? seconds[phase]/total : 0;
+    }
+
+    //! writes the metrics, with those of the proposer, as a JSON object.
+    void export_json(std::string file_name, ProposerMetrics const& proposer) const {
+        std::ofstream file(file_name.c_str());
+        file << "{\"steps\": " << steps << ", \"seconds\": " << seconds_elapsed()
+             << ", \"steps_per_second\": " << steps_per_second() << ",\n";
+        file << " \"proposer\": ";
+        proposer.write_json(file);
+        file << ",\n \"time_per_step\": {";
+        for (unsigned int phase = 0; phase < PHASES; phase++)
+            file << (phase ? ", " : "") << "\"" << phase_name(phase) << "\": "
+                 << (timed_steps ? seconds[phase]/timed_steps : 0);
+        file << "},\n \"round_trips\": ";
+        round_trips.write_json(file);
+        file << ",\n \"tunnelling\": ";
+        tunnelling.write_json(file);
+        file << ",\n \"acceptance\": {";
+        bool first = true;
+        for (unsigned int triangles = 0; triangles < proposed.size(); triangles++)
+            if (proposed[triangles]) {
+                file << (first ? "" : ", ") << "\"" << triangles << "\": " << acceptance(triangles);
+                first = false;
+            }
+        file << "}}\n";
+    }
+
+    //! writes rows `triangles,proposed,accepted,acceptance` with a header.
+    void export_csv(std::string file_name) const {
+        std::ofstream file(file_name.c_str());
+        file << "triangles,proposed,accepted,acceptance\n";
+        for (unsigned int triangles = 0; triangles < proposed.size(); triangles++)
+            if (proposed[triangles])
+                file << triangles << "," << proposed[triangles] << "," << accepted[triangles] << ","
+                     << acceptance(triangles) << "\n";
+    }
+
+    //! Makes the sampler export the metrics to `prefix`.json and `prefix`.csv every `interval` seconds.
+    void set_export(std::string prefix, double interval) {
+        export_prefix = prefix;
+        export_interval = interval;
+        last_export = Clock::now();
+    }
+
+    inline std::string const& get_export_prefix() const {return export_prefix;}
+
+    //! whether the periodic export is due, checking the clock only once in `export_period()` steps.
+    inline bool export_due() {
+        if (export_prefix.empty() or steps % export_period() != 0)
+            return false;
+        Clock::time_point now = Clock::now();
+        if (std::chrono::duration<double>(now - last_export).count() < export_interval)
+            return false;
+        last_export = now;
+        return true;
+    }
+};
+
+#else
+
+//! `ProposerMetrics` without `TRIANGLES_METRICS`: does nothing.
+struct ProposerMetrics {
+    static const bool enabled = false;
+
+    inline void proposal() {}
+    inline void new_link_draw() {}
+    inline void old_link_draw() {}
+};
+
+//! `SamplerMetrics` without `TRIANGLES_METRICS`: does nothing.
+struct SamplerMetrics {
+    static const bool enabled = false;
+
+    enum Phase {PROPOSAL, TRIANGLES, ACCEPTANCE, APPLY, PHASES};
+
+    inline void reset() {}
+    inline void begin_step() {}
+    inline void lap(Phase) {}
+    inline void end_step(unsigned int, bool) {}
+    inline void visit_bin(unsigned int, unsigned int) {}
+    inline bool export_due() {return false;}
+
+    inline std::string get_export_prefix() const {return std::string();}
+    void export_json(std::string, ProposerMetrics const&) const {disabled();}
+    void export_csv(std::string) const {disabled();}
+    void set_export(std::string, double) {disabled();}
+
+    static void disabled() {
+        std::cout << "metrics are not exported: compile with -DTRIANGLES_METRICS" << std::endl;
+    }
+};
+
+#endif
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef triangles_motifs_h
+#define triangles_motifs_h
+
+#include <vector>
+#include <string>
+
+#include "network.h"
+
+
+//! Counters of motifs, to constrain motifs other than triangles (see `MotifNetwork`).
+//! A counter is a class with
+//!  - `static std::string name()`;
+//!  - `static unsigned int count(Network const& network)`, the motifs of a network,
+//!    counted from scratch;
+//!  - `static unsigned int added(Network const& network, unsigned int node_i, unsigned int node_j)`,
+//!    the motifs that adding the link node_i-node_j (not in the network) creates,
+//!    which are also those that removing it destroys, once removed.
+
+//! Triangles, as counted by `Network` itself.
+struct TriangleCounter {
+    static std::string name() {return "triangles";}
+
+    static unsigned int count(Network const& network) {return network.get_triangles();}
+
+    static unsigned int added(Network const& network, unsigned int node_i, unsigned int node_j) {
+        return network.common_neighbours(node_i, node_j);
+    }
+};
+
+
+//! Wedges: paths of two links, \sum_i degree_i*(degree_i - 1)/2. The double-edge
+//! swaps keep the degrees, so the samplers do not change them; they are useful
+//! with other changes of links.
+struct WedgeCounter {
+    static std::string name() {return "wedges";}
+
+    static unsigned int count(Network const& network) {
+        unsigned int result = 0;
+        for (unsigned int node_i = 0; node_i < network.getN(); node_i++) {
+            unsigned int degree = (unsigned int)network.get_links(node_i).size();
+            result += degree*(degree - 1)/2;
+        }
+        return result;
+    }
+
+    //! a wedge with each of the other links of node_i and node_j.
+    static unsigned int added(Network const& network, unsigned int node_i, unsigned int node_j) {
+        return (unsigned int)(network.get_links(node_i).size() + network.get_links(node_j).size());
+    }
+};
+
+
+//! Squares: cycles of four links, without regard to the links across them.
+struct SquareCounter {
+    static std::string name() {return "squares";}
+
+    //! Every pair of paths node_i-k-node_j of two links is a square, found once
+    //! from each of its two diagonals.
+    static unsigned int count(Network const& network) {
+        std::vector<unsigned int> paths(network.getN(), 0);  // from node_i to each node_j > node_i
+        std::vector<unsigned int> ends;
+        unsigned long long result = 0;
+        for (unsigned int node_i = 0; node_i < network.getN(); node_i++) {
+            for (unsigned int node_k : network.get_links(node_i))
+                for (unsigned int node_j : network.get_links(node_k))
+                    if (node_j > node_i and paths[node_j]++ == 0)
+                        ends.push_back(node_j);
+            for (unsigned int node_j : ends) {
+                result += paths[node_j]*(paths[node_j] - 1)/2;
+                paths[node_j] = 0;
+            }
+            ends.clear();
+        }
+        return (unsigned int)(result/2);
+    }
+
+    //! a square with each path node_i-k-l-node_j of three links: for each neighbour
+    //! k of node_i, the common neighbours l of k and node_j (never node_i, not a neighbour of node_j).
+    static unsigned int added(Network const& network, unsigned int node_i, unsigned int node_j) {
+        unsigned int result = 0;
+        for (unsigned int node_k : network.get_links(node_i))
+            result += network.common_neighbours(node_k, node_j);
+        return result;
+    }
+};
+
+
+//! Cliques of four nodes.
+struct CliqueCounter {
+    static std::string name() {return "cliques";}
+
+    //! every clique once, from the link of its two lowest nodes.
+    static unsigned int count(Network const& network) {
+        std::vector<unsigned int> common(network.getN());
+        unsigned int result = 0;
+        for (unsigned int node_i = 0; node_i < network.getN(); node_i++)
+            for (unsigned int node_j : network.get_links(node_i))
+                if (node_j > node_i) {
+                    unsigned int size = network.common_neighbours(node_i, node_j, common.data());
+                    unsigned int first = 0;
+                    while (first < size and common[first] < node_j)
+                        first++;
+                    result += linked_pairs(network, common.data() + first, size - first);
+                }
+        return result;
+    }
+
+    //! a clique with each linked pair of common neighbours of node_i and node_j.
+    static unsigned int added(Network const& network, unsigned int node_i, unsigned int node_j) {
+        unsigned int size = (unsigned int)std::min(network.get_links(node_i).size(), network.get_links(node_j).size());
+        unsigned int buffer[64];
+        std::vector<unsigned int> large(size > 64 ? size : 0);
+        unsigned int* common = size > 64 ? large.data() : buffer;
+        size = network.common_neighbours(node_i, node_j, common);
+        return linked_pairs(network, common, size);
+    }
+
+    static unsigned int linked_pairs(Network const& network, unsigned int const* nodes, unsigned int size) {
+        unsigned int result = 0;
+        for (unsigned int a = 0; a < size; a++) {
+            auto const& list = network.get_links(nodes[a]);
+            for (unsigned int b = a + 1; b < size; b++)
+                result += (unsigned int)list.count(nodes[b]);
+        }
+        return result;
+    }
+};
+
+
+//! A network whose samplers constrain the motifs of `Counter` instead of the
+//! triangles: `get_motifs` and `delta_motifs` are of the counter's motifs, which
+//! are counted once and then updated incrementally by `add_link` and `remove_link`.
+//! The change of a double-edge swap AB, CD -> AC, DB is the sum of the changes of
+//! its four link changes in sequence, evaluated on the links lists changed in place
+//! and restored (the triangles are not touched).
+template <class Counter>
+class MotifNetwork : public Network {
+protected:
+    unsigned int motifs;
+
+    //! changes of the links lists alone, for `delta_motifs`.
+    inline void link(unsigned int node_i, unsigned int node_j) {
+        links[node_i].insert(node_j);
+        links[node_j].insert(node_i);
+    }
+    inline void unlink(unsigned int node_i, unsigned int node_j) {
+        links[node_i].erase(node_j);
+        links[node_j].erase(node_i);
+    }
+public:
+    MotifNetwork(Network const& network) : Network(network), motifs(Counter::count(*this)) {}
+
+    inline unsigned int get_motifs() const {return motifs;}
+
+    int delta_motifs(GeneratedProposal const& proposal) {
+        Link const& ab = proposal.old_link1;
+        Link const& cd = proposal.old_link2;
+        Link const& ac = proposal.new_link1;
+        Link const& db = proposal.new_link2;
+
+        unlink(ab.first, ab.second);
+        int delta = -(int)Counter::added(*this, ab.first, ab.second);
+        unlink(cd.first, cd.second);
+        delta -= (int)Counter::added(*this, cd.first, cd.second);
+        delta += (int)Counter::added(*this, ac.first, ac.second);
+        link(ac.first, ac.second);
+        delta += (int)Counter::added(*this, db.first, db.second);
+
+        unlink(ac.first, ac.second);
+        link(cd.first, cd.second);
+        link(ab.first, ab.second);
+        return delta;
+    }
+
+    void add_link(unsigned int node_i, unsigned int node_j) {
+        motifs += Counter::added(*this, node_i, node_j);
+        Network::add_link(node_i, node_j);
+    }
+
+    void remove_link(unsigned int node_i, unsigned int node_j) {
+        Network::remove_link(node_i, node_j);
+        motifs -= Counter::added(*this, node_i, node_j);
+    }
+
+    //! Reads a network written by `write` (e.g. of a checkpoint) and counts its motifs.
+    void read(io::BinaryReader & reader) {
+        Network::read(reader);
+        motifs = Counter::count(*this);
+    }
+};
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef triangles_multicanonical_h
+#define triangles_multicanonical_h
+
+#include <memory>
+
+#include "sampler.h"
+#include "reweighting.h"
+#include "parallel.h"
+
+
+//! Means of observables of the sampled networks per bin of triangles.
+class BinObservables {
+protected:
+    std::vector<std::string> names;
+    std::vector<unsigned long long> counts;  // samples per bin
+    std::vector<double> sums;                // of observable k in bin b at b*names.size() + k
+public:
+    BinObservables(unsigned int size=0, std::vector<std::string> const& names={}) :
+    names(names), counts(size, 0), sums(size*names.size(), 0) {}
+
+    inline unsigned int size() const {return (unsigned int)counts.size();}
+    inline std::vector<std::string> const& get_names() const {return names;}
+
+    void add(unsigned int bin, std::vector<double> const& values) {
+        assert(values.size() == names.size());
+        counts[bin]++;
+        for (unsigned int k = 0; k < values.size(); k++)
+            sums[bin*names.size() + k] += values[k];
+    }
+
+    void merge(BinObservables const& other) {
+        assert(other.names == names and other.size() == size());
+        for (unsigned int bin = 0; bin < counts.size(); bin++)
+            counts[bin] += other.counts[bin];
+        for (unsigned int i = 0; i < sums.size(); i++)
+            sums[i] += other.sums[i];
+    }
+
+    inline unsigned long long count(unsigned int bin) const {return counts[bin];}
+
+    //! the mean of the observable `k` on each bin, NAN where there are no samples.
+    std::vector<double> means(unsigned int k) const {
+        std::vector<double> result(counts.size(), NAN);
+        for (unsigned int bin = 0; bin < counts.size(); bin++)
+            if (counts[bin] > 0)
+                result[bin] = sums[bin*names.size() + k]/counts[bin];
+        return result;
+    }
+
+    //! exports rows `bin samples mean_0 mean_1 ...` of the bins with samples.
+    void export_observables(std::string file_name) const {
+        std::vector<std::vector<double> > data;
+        for (unsigned int bin = 0; bin < counts.size(); bin++)
+            if (counts[bin] > 0) {
+                std::vector<double> row(1, bin);
+                row.push_back((double)counts[bin]);
+                for (unsigned int k = 0; k < names.size(); k++)
+                    row.push_back(sums[bin*names.size() + k]/counts[bin]);
+                data.push_back(row);
+            }
+        io::save(data, file_name);
+    }
+};
+
+
+//! Multicanonical production runs: `chains` independent chains sample networks
+//! with the fixed weights exp(-S(t)) of an entropy estimated before (e.g. by
+//! `WangLandauSampler::export_entropy`), so every number of triangles is about
+//! equally visited. Each chain is a `WindowSampler` on [lower, upper] with its own
+//! network and random stream; they run in parallel and their histograms and
+//! observables are merged at the end. Canonic averages at any beta follow by
+//! reweighting (see `entropy` and reweighting.h).
+class MulticanonicalSampler {
+protected:
+    struct Chain {
+        Network network;
+        Histogram<unsigned int> histogram;
+        Random rng;
+        WindowSampler sampler;
+        BinObservables observables;
+
+        Chain(Network const& network, unsigned int lower, unsigned int upper,
+              unsigned int seed, unsigned int stream) :
+        network(network), histogram(lower, upper, upper - lower), rng(seed, stream),
+        sampler(rng, this->histogram, this->network) {}
+    };
+
+    unsigned int lower;
+    unsigned int upper;
+    std::vector<double> weights;  // S(t) of the sampling
+    std::vector<std::unique_ptr<Chain> > chains;
+
+    std::string networks_prefix;  // empty if no networks are saved
+    unsigned int networks_per_bin;
+public:
+    //! `weights` is the entropy of the bins of [lower, upper] (e.g. of a Wang-Landau
+    //! on the same range); bins without one (NAN, e.g. never visited) get the largest entropy.
+    MulticanonicalSampler(Network const& network, unsigned int lower, unsigned int upper,
+                          std::vector<double> const& weights, unsigned int chains_count, unsigned int seed=2) :
+    lower(lower), upper(upper), weights(weights), networks_per_bin(0) {
+        assert(weights.size() == upper - lower + 1 and chains_count > 0);
+        double S_max = -std::numeric_limits<double>::infinity();
+        for (double value : weights)
+            if (not std::isnan(value))
+                S_max = std::max(S_max, value);
+        for (double & value : this->weights)
+            if (std::isnan(value))
+                value = S_max;
+
+        for (unsigned int index = 0; index < chains_count; index++) {
+            chains.push_back(std::unique_ptr<Chain>(new Chain(network, lower, upper, seed, index)));
+            chains.back()->sampler.set_entropy(this->weights);
+        }
+    }
+
+    //! Same, with the weights of a file of `export_entropy`.
+    MulticanonicalSampler(Network const& network, unsigned int lower, unsigned int upper,
+                          std::string entropy_file, unsigned int chains_count, unsigned int seed=2) :
+    MulticanonicalSampler(network, lower, upper, reweighting::load_entropy(entropy_file, upper - lower + 1),
+                          chains_count, seed) {}
+
+    inline unsigned int get_chains() const {return (unsigned int)chains.size();}
+    inline std::vector<double> const& get_weights() const {return weights;}
+
+    //! Makes `sample` save, for every bin, the first `per_bin` samples of each
+    //! chain to "<prefix>_<triangles>_<chain>_<index>.bin" (see `Network::save_binary`).
+    void set_network_output(std::string prefix, unsigned int per_bin) {
+        networks_prefix = prefix;
+        networks_per_bin = per_bin;
+    }
+
+    //! Takes `samples` samples on every chain, `thinning` steps apart, and records
+    //! `observables(network)`, a vector with a value per name of `names`, on their bin.
+    template <class Observables>
+    void sample(unsigned int samples, unsigned int thinning, std::vector<std::string> const& names,
+                Observables const& observables, unsigned int threads=parallel::threads()) {
+        parallel::for_each((unsigned int)chains.size(), [&](unsigned int index) {
+            Chain & chain = *chains[index];
+            chain.observables = BinObservables((unsigned int)weights.size(), names);
+            chain.histogram.reset();
+            chain.sampler.sample(samples, thinning, [&](Network const& network) {
+                unsigned int bin = chain.histogram.bin(network.get_triangles());
+                chain.observables.add(bin, observables(network));
+                if (not networks_prefix.empty() and chain.observables.count(bin) <= networks_per_bin)
+                    network.save_binary(format("%s_%d_%d_%d.bin", networks_prefix.c_str(), lower + bin, index,
+                                               (int)chain.observables.count(bin)));
+            });
+        }, threads);
+    }
+
+    //! Same, recording only the number of samples per bin.
+    void sample(unsigned int samples, unsigned int thinning, unsigned int threads=parallel::threads()) {
+        sample(samples, thinning, std::vector<std::string>(),
+               [](Network const&) {return std::vector<double>();}, threads);
+    }
+
+    //! the visits of all chains in the last `sample`, at every step.
+    Histogram<unsigned int> histogram() const {
+        Histogram<unsigned int> result(chains[0]->histogram);
+        for (unsigned int index = 1; index < chains.size(); index++)
+            result.merge(chains[index]->histogram);
+        return result;
+    }
+
+    //! the observables of all chains in the last `sample`.
+    BinObservables observables() const {
+        BinObservables result(chains[0]->observables);
+        for (unsigned int index = 1; index < chains.size(); index++)
+            result.merge(chains[index]->observables);
+        return result;
+    }
+
+    //! the entropy corrected by the visits of the chains (see `reweighting::entropy`).
+    std::vector<double> entropy() const {
+        Histogram<unsigned int> visits(histogram());
+        std::vector<unsigned int> counts(weights.size());
+        for (unsigned int bin = 0; bin < counts.size(); bin++)
+            counts[bin] = visits[bin];
+        return reweighting::entropy(weights, counts);
+    }
+
+    //! canonic average at `beta` of the observable `k` recorded by `sample`.
+    double canonic_average(unsigned int k, double beta) const {
+        return reweighting::canonic_average(entropy(), observables().means(k), beta, lower);
+    }
+
+    //! exports the corrected entropy in the format of `WangLandauSampler::export_entropy`.
+    void export_entropy(std::string file_name) const {
+        std::vector<double> S(entropy());
+        std::vector<std::vector<double> > data;
+        for (unsigned int bin = 0; bin < S.size(); bin++)
+            if (not std::isnan(S[bin])) {
+                std::vector<double> row(2);
+                row[0] = bin;
+                row[1] = S[bin];
+                data.push_back(row);
+            }
+        io::save(data, file_name);
+    }
+};
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef triangles_multiple_walkers_h
+#define triangles_multiple_walkers_h
+
+#include <memory>
+
+#include "sampler.h"
+#include "parallel.h"
+
+
+//! Wang-Landau with several walkers sharing one entropy: each walker has its own
+//! network and proposer and runs in parallel for `merge_interval` steps on its
+//! copy of the entropy; then the increments of all walkers are added to the
+//! shared entropy, which is copied back to every walker. The modification factor
+//! is reduced when the walkers finished `round_trips` round-trips between them,
+//! so the WL steps of N walkers are (ideally) N times shorter in wall time.
+class MultipleWalkerWangLandau {
+protected:
+    unsigned int lower;
+    unsigned int upper;
+
+    std::vector<std::unique_ptr<WangLandauWalker> > walkers;
+    std::vector<double> entropy;  // shared by all walkers after each merge
+
+    //! adds the increments of every walker since the last merge to the shared entropy.
+    void merge() {
+        std::vector<double> merged(entropy);
+        for (std::unique_ptr<WangLandauWalker> const& walker : walkers) {
+            std::vector<double> const& walker_entropy = walker->sampler.get_entropy();
+            for (unsigned int bin = 0; bin < entropy.size(); bin++)
+                merged[bin] += walker_entropy[bin] - entropy[bin];
+        }
+        entropy.swap(merged);
+        for (std::unique_ptr<WangLandauWalker> const& walker : walkers)
+            walker->sampler.set_entropy(entropy);
+    }
+
+public:
+    MultipleWalkerWangLandau(Network const& network, unsigned int lower, unsigned int upper,
+                             unsigned int walkers_count, unsigned int seed=2) :
+    lower(lower), upper(upper), entropy(upper - lower + 1, 0) {
+        assert(walkers_count > 0);
+        for (unsigned int index = 0; index < walkers_count; index++)
+            walkers.push_back(std::unique_ptr<WangLandauWalker>(new WangLandauWalker(network, lower, upper,
+                                                                                     seed, index)));
+    }
+
+    inline unsigned int get_walkers() const {return (unsigned int)walkers.size();}
+    inline std::vector<double> const& get_entropy() const {return entropy;}
+    inline double get_f() const {return walkers[0]->sampler.get_f();}
+    inline unsigned int get_wl_step() const {return walkers[0]->sampler.get_wl_step();}
+
+    //! round-trips of all walkers in the current WL step.
+    unsigned int get_round_trip() const {
+        unsigned int result = 0;
+        for (std::unique_ptr<WangLandauWalker> const& walker : walkers)
+            result += walker->sampler.get_round_trip();
+        return result;
+    }
+
+    //! number of visits to `triangles` of all walkers in the current WL step.
+    unsigned int get_histogram(unsigned int triangles) const {
+        unsigned int result = 0;
+        for (std::unique_ptr<WangLandauWalker> const& walker : walkers)
+            result += walker->histogram[walker->histogram.bin(triangles)];
+        return result;
+    }
+
+    //! Runs WL steps until `total_steps` finished, each one lasting until the
+    //! walkers finished `round_trips` round-trips together.
+    void sample(unsigned int total_steps, unsigned int round_trips=5, unsigned int merge_interval=1000,
+                unsigned int threads=parallel::threads()) {
+        parallel::for_each((unsigned int)walkers.size(), [this](unsigned int index) {
+            walkers[index]->sampler.move_into_range();
+        }, threads);
+
+        while (get_wl_step() < total_steps) {
+            parallel::for_each((unsigned int)walkers.size(), [this, merge_interval](unsigned int index) {
+                for (unsigned int step = 0; step < merge_interval; step++)
+                    walkers[index]->sampler.round_trip_step();
+            }, threads);
+            merge();
+
+            if (get_round_trip() >= round_trips) {
+                for (std::unique_ptr<WangLandauWalker> const& walker : walkers) {
+                    walker->sampler.wang_landau_step();
+                    walker->histogram.reset();
+                }
+            }
+        }
+    }
+
+    //! exports the normalized entropy, \sum(exp(S)) == 1, in the format of
+    //! `WangLandauSampler::export_entropy` (visited numbers of triangles only).
+    void export_entropy(std::string file_name) const {
+        double S_max = -std::numeric_limits<double>::infinity();
+        for (double value : entropy)
+            if (value > 0 and value > S_max)
+                S_max = value;
+        double C = 0;
+        for (double value : entropy)
+            if (value > 0)
+                C += exp(value - S_max);
+        C = S_max + log(C);
+
+        std::vector<std::vector<double> > data;
+        for (unsigned int triangles = lower; triangles <= upper; triangles++)
+            if (entropy[triangles - lower] > 0) {
+                std::vector<double> row(2);
+                row[0] = triangles;
+                row[1] = entropy[triangles - lower] - C;
+                data.push_back(row);
+            }
+        io::save(data, file_name);
+    }
+};
+
+#endif
@@ -8,9 +8,34 @@
 #include <unordered_map>
 #include <string>
 #include <algorithm>
+#include <atomic>
+#include <limits>
 
 #include "io.h"
+#include "link_list.h"
+#include "link_index.h"
+#include "intersection.h"
+#include "parallel.h"
+
+
+//! The container with the nodes linked to a node. By default the links are
+//! stored in sorted contiguous arrays; define `TRIANGLES_SET_LINKS` to use the
+//! original `std::set` (red-black tree) storage.
+#ifdef TRIANGLES_SET_LINKS
+typedef std::set<unsigned int> LinkList;
+#else
+typedef SortedLinkList LinkList;
+#endif
+
 
+//! a proposal of FixedDegree is identified by 4 links:
+//! 2 old links that will be removed and 2 new links that will be added.
+struct GeneratedProposal {
+    Link old_link1;
+    Link old_link2;
+    Link new_link1;
+    Link new_link2;
+};
 
 //! A network defined by nodes indexed by 0,1,...,N-1 and a link list.
 //! The link list is of the form n_i: {n_j,...,n_k} where n_j...n_k are nodes
@@ -22,32 +47,135 @@ protected:
     std::vector<unsigned int> node_list; //! node_i -> data_node_i
     std::unordered_map<unsigned int, unsigned int> backwards_list; //! data_node_i -> node_i
 
-    std::vector<std::set<unsigned int> > links; //! links list of `node_i`
+    std::vector<LinkList> links; //! links list of `node_i`
+
+    LinkIndex link_index; //! used to draw a random link in constant time.
 
     unsigned int total_triangles;
     std::vector<unsigned int> triangle_count; //! a cache.
 
-    //! computes the number of triangles that a given node has.
+    io::ParseStatistics parse_statistics = io::ParseStatistics();
+
+    std::vector<unsigned int> common; //! buffer for the common neighbours of a link.
+
+    //! number of nodes in both lists, using the kernels of intersection.h.
+    static inline unsigned int intersection_size(SortedLinkList const& list_i, SortedLinkList const& list_j) {
+        return (unsigned int)intersection::count(list_i.data(), list_i.size(), list_j.data(), list_j.size());
+    }
+
+    //! writes the nodes in both lists to `out` and returns how many there are.
+    static inline unsigned int intersection(SortedLinkList const& list_i, SortedLinkList const& list_j,
+                                            unsigned int* out) {
+        return (unsigned int)intersection::intersect(list_i.data(), list_i.size(),
+                                                     list_j.data(), list_j.size(), out);
+    }
+
+    //! generic versions of the above for other sorted containers (e.g. `std::set`).
+    template <class List>
+    static unsigned int intersection_size(List const& list_i, List const& list_j) {
+        return intersection(list_i, list_j, nullptr);
+    }
+
+    template <class List>
+    static unsigned int intersection(List const& list_i, List const& list_j, unsigned int* out) {
+        unsigned int result = 0;
+        typename List::const_iterator it_i = list_i.begin(), it_j = list_j.begin();
+        while (it_i != list_i.end() and it_j != list_j.end()) {
+            if (*it_i < *it_j)
+                ++it_i;
+            else if (*it_j < *it_i)
+                ++it_j;
+            else {
+                if (out)
+                    out[result] = *it_i;
+                result++;
+                ++it_i;
+                ++it_j;
+            }
+        }
+        return result;
+    }
+
+    //! computes the number of triangles that a given node has: each linked pair
+    //! of neighbours of node_i is counted once from each of them.
     unsigned int compute_triangles(unsigned int node_i) const {
         unsigned int triangles = 0;
         for (unsigned int node_j : links[node_i])
-            for (unsigned int node_k : links[node_i])
-                if (node_k != node_j and links[node_j].count(node_k))
-                    triangles++;
+            triangles += intersection_size(links[node_i], links[node_j]);
         return triangles/2;
     }
 
-    //! Uses a brute force loop O(Nnodes^3) to compute the number of triangles:
-    //! for every node_i, goes to neiber node_j and checks if neiber of
-    //! node_j, node_k, is node_i.
-    void compute_triangles() {
+    //! Computes the number of triangles of every node with the forward algorithm:
+    //! links are oriented from the lower to the higher (degree, node) and every
+    //! triangle is found once, as a common forward link of its two lowest nodes.
+    //! Nodes are distributed over `threads` threads.
+    void compute_all_triangles(unsigned int threads) {
+        unsigned int N = getN();
+        auto precedes = [this](unsigned int node_i, unsigned int node_j) {
+            return links[node_i].size() < links[node_j].size() or
+                   (links[node_i].size() == links[node_j].size() and node_i < node_j);
+        };
+
+        // forward links of every node, sorted by node
+        std::vector<size_t> offsets(N + 1, 0);
+        for (unsigned int node_i = 0; node_i < N; node_i++) {
+            offsets[node_i + 1] = offsets[node_i];
+            for (unsigned int node_j : links[node_i])
+                if (precedes(node_i, node_j))
+                    offsets[node_i + 1]++;
+        }
+        std::vector<unsigned int> forward(offsets[N]);
+        for (unsigned int node_i = 0; node_i < N; node_i++) {
+            size_t position = offsets[node_i];
+            for (unsigned int node_j : links[node_i])
+                if (precedes(node_i, node_j))
+                    forward[position++] = node_j;
+        }
+
+        std::vector<std::atomic<unsigned int> > counts(N);
+        for (unsigned int node_i = 0; node_i < N; node_i++)
+            counts[node_i].store(0, std::memory_order_relaxed);
+
+        const unsigned int nodes_per_task = 1024;
+        parallel::for_each((N + nodes_per_task - 1)/nodes_per_task, [&](unsigned int task) {
+            std::vector<unsigned int> common;
+            unsigned int last_node = std::min(N, (task + 1)*nodes_per_task);
+            for (unsigned int node_i = task*nodes_per_task; node_i < last_node; node_i++) {
+                unsigned int const* forward_i = forward.data() + offsets[node_i];
+                size_t degree_i = offsets[node_i + 1] - offsets[node_i];
+
+                unsigned int triangles_i = 0;
+                for (size_t j = 0; j < degree_i; j++) {
+                    unsigned int node_j = forward_i[j];
+                    unsigned int const* forward_j = forward.data() + offsets[node_j];
+                    size_t degree_j = offsets[node_j + 1] - offsets[node_j];
+
+                    if (common.size() < std::min(degree_i, degree_j))
+                        common.resize(std::min(degree_i, degree_j));
+                    unsigned int triangles = (unsigned int)intersection::intersect(forward_i, degree_i,
+                                                                                  forward_j, degree_j,
+                                                                                  common.data());
+                    triangles_i += triangles;
+                    counts[node_j].fetch_add(triangles, std::memory_order_relaxed);
+                    for (unsigned int k = 0; k < triangles; k++)
+                        counts[common[k]].fetch_add(1, std::memory_order_relaxed);
+                }
+                counts[node_i].fetch_add(triangles_i, std::memory_order_relaxed);
+            }
+        }, threads);
+
         total_triangles = 0;
-        for (unsigned int node_i = 0; node_i < getN(); node_i++) {
-            triangle_count[node_i] = compute_triangles(node_i);
+        for (unsigned int node_i = 0; node_i < N; node_i++) {
+            triangle_count[node_i] = counts[node_i].load(std::memory_order_relaxed);
             total_triangles += triangle_count[node_i];
         }
     }
 
+    //! Computes the number of triangles of every node, using all cores for large networks.
+    void compute_triangles() {
+        compute_all_triangles(link_index.size() > 100000 ? parallel::threads() : 1);
+    }
+
     //! Utility function used to update number of triangles after the network
     //! changed.
     //! If added=true, updates assuming a new link between node_i and node_j.
@@ -55,33 +183,31 @@ protected:
     void update_triangles(unsigned int node_i, unsigned int node_j, bool added) {
         int sign = 2*added - 1;
 
-        // update triangles in node_i
-        unsigned int removed_triangles_i = 0;
-        for (unsigned int node_k : links[node_i])
-            if (node_k != node_j and links[node_j].count(node_k))
-                removed_triangles_i++;
-        triangle_count[node_i] += sign*removed_triangles_i;
-        total_triangles += sign*removed_triangles_i;
-
-        // update triangles in node_j
-        unsigned int removed_triangles_j = 0;
-        for (unsigned int node_k : links[node_j])
-            if (node_k != node_i and links[node_i].count(node_k))
-                removed_triangles_j++;
-        triangle_count[node_j] += sign*removed_triangles_j;
-        total_triangles += sign*removed_triangles_j;
-
-        // update triangles in the other nodes.
-        std::vector<unsigned int> intersection;
-        std::set_intersection(links[node_i].begin(),
-                              links[node_i].end(),
-                              links[node_j].begin(),
-                              links[node_j].end(),
-                              std::back_inserter(intersection));
-
-        for (unsigned int node_k : intersection)
-            triangle_count[node_k] += sign*1;
-        total_triangles += sign*intersection.size();
+        // each common neighbour node_k of node_i and node_j is a triangle
+        // (node_i, node_j, node_k) that is added or removed.
+        size_t max_common = std::min(links[node_i].size(), links[node_j].size());
+        if (common.size() < max_common)
+            common.resize(max_common);
+        unsigned int triangles = intersection(links[node_i], links[node_j], common.data());
+
+        triangle_count[node_i] += sign*triangles;
+        triangle_count[node_j] += sign*triangles;
+        for (unsigned int k = 0; k < triangles; k++)
+            triangle_count[common[k]] += sign;
+        total_triangles += 3*sign*triangles;
+    }
+
+    //! builds the index of links from the links list.
+    void compute_link_index() {
+        size_t total_links = 0;
+        for (unsigned int node_i = 0; node_i < getN(); node_i++)
+            total_links += links[node_i].size();
+        link_index.clear();
+        link_index.reserve(total_links/2);
+        for (unsigned int node_i = 0; node_i < getN(); node_i++)
+            for (unsigned int node_j : links[node_i])
+                if (node_i < node_j)
+                    link_index.insert(node_i, node_j);
     }
 
     //! Checks that link list is consistent: if contains AB then also contains BA.
@@ -90,6 +216,83 @@ protected:
             for(unsigned int node_j : links[node_i])
                 assert(links[node_j].count(node_i) == 1);
     }
+
+    //! first 8 bytes of a file written by `save_binary`.
+    static char const* binary_format() {
+        return "TRINET01";
+    }
+
+    //! Reads a network from a file written by `save_binary` (see `read`).
+    void load_binary(std::string path) {
+        io::MappedFile file(path);
+        io::BinaryReader reader(file);
+        if (not reader.starts_with(binary_format(), 8)) {
+            std::cout << "file \"" << path << "\" is not a binary network" << std::endl;
+            exit(1);
+        }
+        reader.read<unsigned long long>();  // the format
+        read(reader);
+    }
+
+    //! Reads a network from a list of links, see `Network(std::string path)`.
+    void load_edge_list(std::string path) {
+        // first pass: the links as pairs of data nodes
+        std::vector<unsigned int> data_links;
+        unsigned int max_data_node = 0;
+        parse_statistics = io::read_edges(path, [&](unsigned int data_node_i, unsigned int data_node_j) {
+            data_links.push_back(data_node_i);
+            data_links.push_back(data_node_j);
+            max_data_node = std::max(max_data_node, std::max(data_node_i, data_node_j));
+        });
+
+        // second pass: number nodes by order of appearance. When data nodes are
+        // not too sparse, a table is faster than `backwards_list`, which is filled at the end.
+        const unsigned int unknown = std::numeric_limits<unsigned int>::max();
+        bool use_table = max_data_node < 4*data_links.size() + 1024;
+        std::vector<unsigned int> table(use_table ? (size_t)max_data_node + 1 : 0, unknown);  // no overflow at UINT_MAX
+        for (unsigned int & data_node : data_links) {
+            unsigned int & node_i = use_table ? table[data_node] : backwards_list.insert(
+                    std::make_pair(data_node, unknown)).first->second;
+            if (node_i == unknown) {
+                node_i = (unsigned int)node_list.size();
+                node_list.push_back(data_node);
+            }
+            data_node = node_i;
+        }
+        std::vector<unsigned int>().swap(table);
+        if (use_table) {
+            backwards_list.reserve(getN());
+            for (unsigned int node_i = 0; node_i < getN(); node_i++)
+                backwards_list[node_list[node_i]] = node_i;
+        }
+
+        std::vector<unsigned int> degree(getN(), 0);
+        for (size_t i = 0; i < data_links.size(); i += 2)
+            if (data_links[i] != data_links[i + 1]) {
+                degree[data_links[i]]++;
+                degree[data_links[i + 1]]++;
+            }
+        std::vector<std::vector<unsigned int> > adjacency(getN());
+        for (unsigned int node_i = 0; node_i < getN(); node_i++)
+            adjacency[node_i].reserve(degree[node_i]);
+        for (size_t i = 0; i < data_links.size(); i += 2)
+            if (data_links[i] != data_links[i + 1]) {
+                adjacency[data_links[i]].push_back(data_links[i + 1]);
+                adjacency[data_links[i + 1]].push_back(data_links[i]);
+            }
+        std::vector<unsigned int>().swap(data_links);
+
+        links.resize(getN());
+        for (unsigned int node_i = 0; node_i < getN(); node_i++) {
+            links[node_i] = LinkList(adjacency[node_i].begin(), adjacency[node_i].end());
+            std::vector<unsigned int>().swap(adjacency[node_i]);
+        }
+
+        triangle_count = std::vector<unsigned int>(getN());
+        check_consistency();
+        compute_link_index();
+        compute_triangles();
+    }
 public:
 
     Network(unsigned int Nnodes, std::vector<std::set<unsigned int> > links) :
@@ -99,48 +302,107 @@ public:
             node_list[node_i] = node_i;
             backwards_list[node_i] = node_i;
             if (node_i < links.size())
-                this->links[node_i] = links[node_i];
+                this->links[node_i] = LinkList(links[node_i].begin(), links[node_i].end());
         }
 
         check_consistency();
+        compute_link_index();
         compute_triangles();
     }
 
-    //! Constructor that takes a file path as a network. It assumes the first two entries (in TSV) are
-    //! the node_i and node_j.
+    //! Constructor that takes a file path as a network. The file is either a binary
+    //! network written by `save_binary` or a list of links, where it assumes the
+    //! first two entries (separated by tabs, spaces or commas) of each line are
+    //! the node_i and node_j; see `io::read_edges`. Repeated links and self-links are ignored.
     Network(std::string path) {
-        std::vector<std::vector<unsigned int> > data(io::load<unsigned int>(path));
-
-        unsigned int node = 0;
-        for (auto vector : data) {
-            assert(vector.size() >= 2);
-            unsigned data_node_i = vector[0];
-            unsigned data_node_j = vector[1];
-
-            if (backwards_list.find(data_node_i) == backwards_list.end()) {
-                node_list.push_back(data_node_i);
-                backwards_list[data_node_i] = node;
-                links.push_back(std::set<unsigned int>());
-                node += 1;
-            }
+        std::ifstream file(path.c_str(), std::ios::binary);
+        char format[8] = {0};
+        file.read(format, 8);
+        file.close();
+
+        if (memcmp(format, binary_format(), 8) == 0)
+            load_binary(path);
+        else
+            load_edge_list(path);
+    }
 
-            if (backwards_list.find(data_node_j) == backwards_list.end()) {
-                node_list.push_back(data_node_j);
-                backwards_list[data_node_j] = node;
-                links.push_back(std::set<unsigned int>());
-                node += 1;
-            }
-            unsigned int node_i = backwards_list[data_node_i];
-            unsigned int node_j = backwards_list[data_node_j];
-            //std::cout << node << " " << node_i << " " << node_j << std::endl;
+    //! statistics of reading the file of the network (zero if not constructed from a file).
+    io::ParseStatistics const& get_parse_statistics() const {return parse_statistics;}
 
-            links[node_i].insert(node_j);
-            links[node_j].insert(node_i);
+    //! Writes the network: its links (as offsets and the concatenated links of
+    //! all nodes), the data nodes, the triangles of every node and the link index.
+    void write(io::BinaryWriter & writer) const {
+        std::vector<unsigned long long> offsets(getN() + 1, 0);
+        std::vector<unsigned int> all_links;
+        for (unsigned int node_i = 0; node_i < getN(); node_i++) {
+            offsets[node_i + 1] = offsets[node_i] + links[node_i].size();
+            all_links.insert(all_links.end(), links[node_i].begin(), links[node_i].end());
         }
 
-        triangle_count = std::vector<unsigned int>(getN());
-        check_consistency();
-        compute_triangles();
+        writer.write(getN());
+        writer.write(offsets.data(), offsets.size());
+        writer.write(all_links.data(), all_links.size());
+        writer.write(node_list.data(), node_list.size());
+        writer.write(triangle_count.data(), triangle_count.size());
+        writer.write(total_triangles);
+        link_index.write(writer);
+    }
+
+    //! Reads a network written by `write`, replacing this one. The offsets, nodes
+    //! and links are checked before they are used, and a file that is truncated
+    //! or inconsistent exits with an error, as `io::read_edges` does.
+    void read(io::BinaryReader & reader) {
+        unsigned int N = reader.read<unsigned int>();
+        unsigned long long const* offsets = reader.read<unsigned long long>((size_t)N + 1);
+        for (unsigned int node_i = 0; node_i < N; node_i++)
+            if (offsets[node_i] > offsets[node_i + 1]) {
+                std::cout << "binary network has decreasing offsets at node " << node_i << std::endl;
+                exit(1);
+            }
+        if (offsets[0] != 0 or offsets[N] > std::numeric_limits<size_t>::max()/sizeof(unsigned int)) {
+            std::cout << "binary network has invalid offsets" << std::endl;
+            exit(1);
+        }
+        unsigned int const* all_links = reader.read<unsigned int>((size_t)offsets[N]);  // exits if beyond the file
+        for (size_t position = 0; position < offsets[N]; position++)
+            if (all_links[position] >= N) {
+                std::cout << "binary network has a link to node " << all_links[position]
+                          << " of " << N << " nodes" << std::endl;
+                exit(1);
+            }
+        unsigned int const* data_nodes = reader.read<unsigned int>(N);
+        unsigned int const* triangles = reader.read<unsigned int>(N);
+
+        links.resize(N);
+        for (unsigned int node_i = 0; node_i < N; node_i++)
+            links[node_i] = LinkList(all_links + offsets[node_i], all_links + offsets[node_i + 1]);
+        node_list.assign(data_nodes, data_nodes + N);
+        triangle_count.assign(triangles, triangles + N);
+        total_triangles = reader.read<unsigned int>();
+        link_index.read(reader);
+        bool valid = 2*(unsigned long long)link_index.size() == offsets[N];
+        for (unsigned int index = 0; valid and index < link_index.size(); index++) {
+            Link const& link = link_index[index];
+            valid = link.first < N and link.second < N and links[link.first].count(link.second);
+        }
+        if (not valid) {
+            std::cout << "binary network has a link index of other links" << std::endl;
+            exit(1);
+        }
+
+        backwards_list.clear();
+        backwards_list.reserve(N);
+        for (unsigned int node_i = 0; node_i < N; node_i++)
+            backwards_list[node_list[node_i]] = node_i;
+    }
+
+    //! Saves the network in a binary file that `Network(std::string path)` loads
+    //! without parsing or counting triangles.
+    void save_binary(std::string file_name) const {
+        io::BinaryWriter writer(file_name);
+        writer.write_bytes(binary_format(), 8);
+        write(writer);
+        writer.close();
     }
 
     //! get number of nodes
@@ -157,14 +419,38 @@ public:
         }
     }
 
-    std::set<unsigned int> const& get_links(unsigned int node_i) const {
+    LinkList const& get_links(unsigned int node_i) const {
         return links[node_i];
     }
 
+    //! get number of links
+    inline unsigned int get_links_count() const {return link_index.size();}
+
+    //! get the `index`-th link of the index of links, 0 <= index < get_links_count().
+    //! The order of the links changes when links are added or removed.
+    inline Link const& get_link(unsigned int index) const {
+        return link_index[index];
+    }
+
+    //! number of nodes linked to both node_i and node_j.
+    inline unsigned int common_neighbours(unsigned int node_i, unsigned int node_j) const {
+        return intersection_size(links[node_i], links[node_j]);
+    }
+
+    //! writes the nodes linked to both node_i and node_j to `out`, in increasing order, and returns how many.
+    inline unsigned int common_neighbours(unsigned int node_i, unsigned int node_j, unsigned int* out) const {
+        return intersection(links[node_i], links[node_j], out);
+    }
+
+    //! number of triangles that node_i is part of.
+    unsigned int get_node_triangles(unsigned int node_i) const {
+        return triangle_count[node_i];
+    }
+
     unsigned int get_triangles() const {
 #ifdef DEBUG
         unsigned int triangles = 0;
-        for (unsigned int node_i = 0; node_i < Nnodes; node_i++) {
+        for (unsigned int node_i = 0; node_i < getN(); node_i++) {
             triangles += triangle_count[node_i];
         }
         assert(triangles == total_triangles);
@@ -172,6 +458,32 @@ public:
         return total_triangles/3;  // each node counts 3 times on each triangle
     }
 
+    //! the motif constrained by the samplers: the triangles (see `MotifNetwork` for others).
+    inline unsigned int get_motifs() const {return get_triangles();}
+    inline int delta_motifs(GeneratedProposal const& proposal) const {return delta_triangles(proposal);}
+
+    //! Computes the change in the number of triangles that applying `proposal`
+    //! (a double-edge swap AB, CD -> AC, DB) would cause, without changing the network.
+    int delta_triangles(GeneratedProposal const& proposal) const {
+        unsigned int node_a = proposal.old_link1.first;
+        unsigned int node_b = proposal.old_link1.second;
+        unsigned int node_c = proposal.old_link2.first;
+        unsigned int node_d = proposal.old_link2.second;
+        assert(proposal.new_link1 == Link(node_a, node_c));
+        assert(proposal.new_link2 == Link(node_d, node_b));
+
+        // removing AB and CD destroys their common neighbours' triangles. Adding AC
+        // after the removals creates the triangles of common neighbours of A and C
+        // except B (if BC exists) and D (if AD exists); same for DB.
+        int delta = (int)common_neighbours(node_a, node_c) + (int)common_neighbours(node_d, node_b)
+                  - (int)common_neighbours(node_a, node_b) - (int)common_neighbours(node_c, node_d);
+        if (links[node_a].count(node_d))
+            delta -= 2;
+        if (links[node_b].count(node_c))
+            delta -= 2;
+        return delta;
+    }
+
     void add_link(unsigned int node_i, unsigned int node_j) {
         assert(links[node_i].count(node_j) == 0);  // link must not exist
 
@@ -179,6 +491,7 @@ public:
 
         links[node_i].insert(node_j);
         links[node_j].insert(node_i);
+        link_index.insert(node_i, node_j);
     }
 
     void remove_link(unsigned int node_i, unsigned int node_j) {
@@ -188,6 +501,7 @@ public:
 
         links[node_i].erase(node_j);
         links[node_j].erase(node_i);
+        link_index.erase(node_i, node_j);
     }
 };
 
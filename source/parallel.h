@@ -0,0 +1,39 @@
+#ifndef triangles_parallel_h
+#define triangles_parallel_h
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+namespace parallel {
+
+    //! number of threads used by default: the number of cores of the machine.
+    inline unsigned int threads() {
+        unsigned int result = std::thread::hardware_concurrency();
+        return result ? result : 1;
+    }
+
+    //! Calls `function(task)` for every task in [0, tasks), distributing the tasks
+    //! dynamically over `threads` threads (the calling thread is one of them).
+    //! Returns when all tasks finished.
+    template <class Function>
+    void for_each(unsigned int tasks, Function function, unsigned int threads = parallel::threads()) {
+        std::atomic<unsigned int> next_task(0);
+        auto worker = [&]() {
+            for (unsigned int task = next_task++; task < tasks; task = next_task++)
+                function(task);
+        };
+
+        if (threads > tasks)
+            threads = tasks;
+        std::vector<std::thread> pool;
+        for (unsigned int thread = 1; thread < threads; thread++)
+            pool.push_back(std::thread(worker));
+        worker();
+        for (std::thread & thread : pool)
+            thread.join();
+    }
+}
+
+#endif
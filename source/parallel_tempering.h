@@ -0,0 +1,165 @@
+#ifndef triangles_parallel_tempering_h
+#define triangles_parallel_tempering_h
+
+#include <memory>
+
+#include "sampler.h"
+#include "parallel.h"
+
+
+//! Parallel tempering: a ladder of `CanonicSampler`s at increasing betas, each
+//! with its own copy of the network, runs in parallel for `exchange_interval`
+//! steps; then neighbouring betas try to swap their networks, with probability
+//! min(1, exp((beta_i - beta_j)*(t_j - t_i))). Networks stuck at a beta escape
+//! by travelling along the ladder, so the mixing is measured by the round-trips
+//! of the networks from the lowest beta to the highest and back.
+//! The histogram of each beta is the histogram of its `CanonicSampler`.
+class ParallelTempering {
+protected:
+    //! a replica owns everything its sampler refers to.
+    struct Replica {
+        Network network;
+        Histogram<unsigned int> histogram;
+        Random rng;
+        CanonicSampler sampler;
+
+        Replica(Network const& network, unsigned int lower, unsigned int upper, double beta,
+                unsigned int seed, unsigned int stream) :
+        network(network), histogram(lower, upper, upper - lower), rng(seed, stream),
+        sampler(rng, this->histogram, this->network, beta) {}
+    };
+
+    // the direction of a network along the ladder, for counting round-trips
+    enum Direction {UNKNOWN, UP, DOWN};
+
+    std::vector<std::unique_ptr<Replica> > replicas;  // replica i is at the i-th smallest beta
+    std::vector<unsigned int> labels;       // the network at replica i started at replica labels[i]
+    std::vector<Direction> directions;      // direction of the network that started at replica i
+    unsigned int round_trips;
+    double seconds;                         // spent in `sample`
+
+    Random rng;  // used for the swaps
+    std::vector<unsigned long long> swaps_proposed;  // between replica i and i + 1
+    std::vector<unsigned long long> swaps_accepted;
+    std::vector<unsigned long long> tune_proposed;   // same, since the last tuning of the ladder
+    std::vector<unsigned long long> tune_accepted;
+
+    //! tries to swap the networks of replicas i and i + 1.
+    void swap(unsigned int i) {
+        Replica & replica_i = *replicas[i];
+        Replica & replica_j = *replicas[i + 1];
+        double delta_beta = replica_i.sampler.get_beta() - replica_j.sampler.get_beta();
+        double delta_triangles = (double)replica_j.network.get_triangles() - replica_i.network.get_triangles();
+
+        swaps_proposed[i]++;
+        tune_proposed[i]++;
+        if (acceptance::metropolis(rng, delta_beta*delta_triangles)) {
+            std::swap(replica_i.network, replica_j.network);
+            std::swap(labels[i], labels[i + 1]);
+            swaps_accepted[i]++;
+            tune_accepted[i]++;
+        }
+    }
+
+    //! updates the directions of the networks at the ends of the ladder.
+    void count_round_trips() {
+        if (directions[labels.front()] == DOWN)
+            round_trips++;
+        directions[labels.front()] = UP;
+        if (directions[labels.back()] == UP)
+            directions[labels.back()] = DOWN;
+    }
+
+public:
+    //! `betas` must be increasing; the histograms cover [lower, upper].
+    ParallelTempering(Network const& network, std::vector<double> const& betas,
+                      unsigned int lower, unsigned int upper, unsigned int seed=2) :
+    labels(betas.size()), directions(betas.size(), UNKNOWN), round_trips(0), seconds(0), rng(seed, 0),
+    swaps_proposed(betas.size(), 0), swaps_accepted(betas.size(), 0),
+    tune_proposed(betas.size(), 0), tune_accepted(betas.size(), 0) {
+        assert(betas.size() > 1);
+        for (unsigned int i = 0; i < betas.size(); i++) {
+            assert(i == 0 or betas[i - 1] < betas[i]);
+            replicas.push_back(std::unique_ptr<Replica>(new Replica(network, lower, upper, betas[i], seed, 1 + i)));
+            labels[i] = i;
+        }
+    }
+
+    inline unsigned int get_replicas() const {return (unsigned int)replicas.size();}
+    inline double get_beta(unsigned int i) const {return replicas[i]->sampler.get_beta();}
+    inline Network const& get_network(unsigned int i) const {return replicas[i]->network;}
+    inline Histogram<unsigned int> const& get_histogram(unsigned int i) const {return replicas[i]->histogram;}
+
+    //! fraction of accepted swaps between replicas i and i + 1.
+    double swap_acceptance(unsigned int i) const {
+        return swaps_proposed[i] ? swaps_accepted[i]*1./swaps_proposed[i] : 0;
+    }
+
+    //! number of networks that went from the lowest beta to the highest and back.
+    inline unsigned int get_round_trips() const {return round_trips;}
+
+    //! round-trips per second spent sampling: how fast the ladder mixes.
+    double round_trips_per_second() const {
+        return seconds > 0 ? round_trips/seconds : 0;
+    }
+
+    //! Moves the inner betas so that the swap acceptances since the last call
+    //! become uniform: each gap is given a share of the ladder proportional to
+    //! its rejection rate, halfway from the current ladder (to damp oscillations).
+    //! The histograms are reset since they would mix different betas.
+    void tune_ladder() {
+        unsigned int gaps = (unsigned int)replicas.size() - 1;
+        std::vector<double> betas(replicas.size());
+        std::vector<double> rejection(gaps);
+        double total_rejection = 0;
+        for (unsigned int i = 0; i < replicas.size(); i++)
+            betas[i] = get_beta(i);
+        for (unsigned int i = 0; i < gaps; i++) {
+            double acceptance = tune_proposed[i] ? tune_accepted[i]*1./tune_proposed[i] : 0;
+            rejection[i] = std::max(1 - acceptance, 0.01);
+            total_rejection += rejection[i];
+            tune_proposed[i] = 0;
+            tune_accepted[i] = 0;
+        }
+
+        unsigned int gap = 0;
+        double cumulative = 0;  // rejection of the gaps before `gap`
+        for (unsigned int i = 1; i < gaps; i++) {
+            double target = i*total_rejection/gaps;
+            while (cumulative + rejection[gap] < target and gap + 1 < gaps) {
+                cumulative += rejection[gap];
+                gap++;
+            }
+            double beta = betas[gap] + (target - cumulative)/rejection[gap]*(betas[gap + 1] - betas[gap]);
+            replicas[i]->sampler.set_beta((betas[i] + beta)/2);
+        }
+        for (std::unique_ptr<Replica> const& replica : replicas)
+            replica->histogram.reset();
+    }
+
+    //! Runs `total_steps` steps on every replica, with swaps every `exchange_interval`
+    //! steps and, if `tune_interval` is not 0, the ladder tuned every `tune_interval` swaps.
+    void sample(unsigned int total_steps, unsigned int exchange_interval=100, unsigned int tune_interval=0,
+                unsigned int threads=parallel::threads()) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        for (unsigned int exchange = 0; exchange*exchange_interval < total_steps; exchange++) {
+            unsigned int steps = std::min(exchange_interval, total_steps - exchange*exchange_interval);
+            parallel::for_each((unsigned int)replicas.size(), [this, steps](unsigned int i) {
+                for (unsigned int step = 0; step < steps; step++)
+                    replicas[i]->sampler.markov_step();
+            }, threads);
+
+            // alternate between the even and the odd pairs of betas
+            for (unsigned int i = exchange % 2; i + 1 < replicas.size(); i += 2)
+                swap(i);
+            count_round_trips();
+
+            if (tune_interval and (exchange + 1) % tune_interval == 0)
+                tune_ladder();
+        }
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+#endif
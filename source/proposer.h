@@ -3,19 +3,7 @@
 
 #include "network.h"
 #include "random.h"
-
-
-typedef std::pair<unsigned int, unsigned int> Link;
-
-
-//! a proposal of FixedDegree is identified by 4 links:
-//! 2 old links that will be removed and 2 new links that will be added.
-struct GeneratedProposal {
-    Link old_link1;
-    Link old_link2;
-    Link new_link1;
-    Link new_link2;
-};
+#include "metrics.h"
 
 
 //! Switches two links constrained to maintain a fixed degree on all nodes.
@@ -23,36 +11,36 @@ struct GeneratedProposal {
 //! 2. Generates a new link "AC"
 //! 3. Picks an existing random link "CD"
 //! 4. Generates the new link "DB"
+//! Its methods are templates on the type of network, such that any class with
+//! the interface of `Network` can be used.
 class FixedDegreeProposer {
 protected:
     Random & rng;
+    mutable ProposerMetrics metrics;  // retries of the loops below (see metrics.h)
 
-    //! 1. Picks an existing random link "AB"
-    Link random_old_link(Network const& network) const {
-        Link link;
-
-        link.first = rng.R(0, network.getN());
+    //! 1. Picks an existing random link "AB", uniformly over all links and
+    //! both of its directions.
+    template <class NetworkType>
+    Link random_old_link(NetworkType const& network) const {
+        assert(network.get_links_count() != 0);
+        Link link = network.get_link(rng.R(0, network.get_links_count()));
 
-        std::set<unsigned int> const& list = network.get_links(link.first);
-        assert(list.size() != 0);
-
-        // generates a random neighberhood, link.second, of link.first
-        unsigned int index_j = rng.R(0, list.size());
-        std::set<unsigned int>::const_iterator it = list.begin();
-        std::advance(it, index_j);
-        link.second = *it;
+        if (rng.R(0, 2))
+            std::swap(link.first, link.second);
 
         return link;
     }
 
     //! 2. Generates a new random link "AC"
     //! ensures that "C != A and C is not neighberhood of A"
-    Link random_new_link(Network const& network, Link old_link) const {
+    template <class NetworkType>
+    Link random_new_link(NetworkType const& network, Link old_link) const {
         Link new_link(old_link);
 
-        std::set<unsigned int> const& list = network.get_links(new_link.first);
+        auto const& list = network.get_links(new_link.first);
         while (list.count(new_link.second) != 0 or new_link.second == new_link.first) {
             new_link.second = rng.R(0, network.getN());
+            metrics.new_link_draw();
         }
 
         return new_link;
@@ -61,20 +49,23 @@ protected:
     //! 3. Picks an existing random link "CD"
     //! ensures that "D != B and B is not a neighberhood of D" since otherwise
     //! `new_link(...)` would generate an existing link.
-    Link old_link(Network const& network, Link new_link1, Link old_link1) const {
+    template <class NetworkType>
+    Link old_link(NetworkType const& network, Link new_link1, Link old_link1) const {
         Link old_link2;
         old_link2.first = new_link1.second;
         old_link2.second = new_link1.first;
 
-        std::set<unsigned int> const& list = network.get_links(old_link2.first);
+        auto const& list = network.get_links(old_link2.first);
 
         while (network.get_links(old_link1.second).count(old_link2.second) != 0 or
                old_link2.second == old_link1.second) {
             // generate a random neighberhood, old_link2.second, of old_link2.first
+            // (constant time, since the links of a node are stored contiguously)
             unsigned int index_j = rng.R(0, list.size());
-            std::set<unsigned int>::const_iterator it = list.begin();
+            auto it = list.begin();
             std::advance(it, index_j);
             old_link2.second = *it;
+            metrics.old_link_draw();
         }
 
         return old_link2;
@@ -93,9 +84,13 @@ public:
 
     FixedDegreeProposer(Random & rng) : rng(rng) {}
 
+    inline ProposerMetrics const& get_metrics() const {return metrics;}
+
     //! generates a valid proposal
-    GeneratedProposal generate_proposal(Network const& network) const {
+    template <class NetworkType>
+    GeneratedProposal generate_proposal(NetworkType const& network) const {
         GeneratedProposal result;
+        metrics.proposal();
 
         result.old_link1 = random_old_link(network);
         result.new_link1 = random_new_link(network, result.old_link1);
@@ -106,7 +101,8 @@ public:
     }
 
     //! Applies the proposal to the network
-    void propose(Network & network, GeneratedProposal const& result) const {
+    template <class NetworkType>
+    void propose(NetworkType & network, GeneratedProposal const& result) const {
         network.remove_link(result.old_link1.first, result.old_link1.second);
         network.remove_link(result.old_link2.first, result.old_link2.second);
         network.add_link(result.new_link1.first, result.new_link1.second);
@@ -115,7 +111,8 @@ public:
 
     //! Uses the proposal to rollback the network to the state it was before
     //! that proposal was applied (inverse of `propose`)
-    void rollback(Network & network, GeneratedProposal const& result) const {
+    template <class NetworkType>
+    void rollback(NetworkType & network, GeneratedProposal const& result) const {
         network.add_link(result.old_link1.first, result.old_link1.second);
         network.add_link(result.old_link2.first, result.old_link2.second);
         network.remove_link(result.new_link1.first, result.new_link1.second);
@@ -123,14 +120,16 @@ public:
     }
 
     //! Utility method that generates the proposal and automatically applies it.
-    void propose(Network & network) const {
+    template <class NetworkType>
+    void propose(NetworkType & network) const {
         GeneratedProposal result = generate_proposal(network);
         propose(network, result);
         check_degree_consistency(network);
     }
 
     //! Asserts that degree is the same on all nodes.
-    static void check_degree_consistency(Network const& network) {
+    template <class NetworkType>
+    static void check_degree_consistency(NetworkType const& network) {
         unsigned int node_0_degree = (unsigned int)network.get_links(0).size();
         for (unsigned int node_i = 1; node_i < network.getN(); node_i++) {
             unsigned int node_i_degree = (unsigned int)network.get_links(node_i).size();
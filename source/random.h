@@ -1,39 +1,180 @@
 #ifndef triangles_random_h
 #define triangles_random_h
 
+#include <cstdint>
 #include <random>
+#include <sstream>
+
+#include "io.h"
+
+
+//! xoshiro256** (Blackman and Vigna): a 64-bit generator with 256 bits of state,
+//! several times faster than `std::mt19937`. It satisfies the requirements of a
+//! uniform random bit generator, so it can be used with the distributions of <random>.
+class Xoshiro256StarStar {
+protected:
+    uint64_t state[4];
+
+    static inline uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+public:
+    typedef uint64_t result_type;
+
+    static constexpr result_type min() {return 0;}
+    static constexpr result_type max() {return ~(result_type)0;}
+
+    //! seeds the state with splitmix64, as recommended by the authors.
+    explicit Xoshiro256StarStar(uint64_t seed = 0) {
+        for (unsigned int i = 0; i < 4; i++) {
+            uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+            state[i] = z ^ (z >> 31);
+        }
+    }
+
+    inline result_type operator()() {
+        uint64_t result = rotl(state[1]*5, 7)*9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    //! Advances the generator by 2^128 calls: calling it n times from the same seed
+    //! gives 2^128 non-overlapping sequences of 2^128 numbers each.
+    void jump() {
+        static const uint64_t polynomial[4] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+                                               0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+        uint64_t jumped[4] = {0, 0, 0, 0};
+        for (unsigned int i = 0; i < 4; i++)
+            for (unsigned int bit = 0; bit < 64; bit++) {
+                if (polynomial[i] & ((uint64_t)1 << bit))
+                    for (unsigned int j = 0; j < 4; j++)
+                        jumped[j] ^= state[j];
+                (*this)();
+            }
+        for (unsigned int j = 0; j < 4; j++)
+            state[j] = jumped[j];
+    }
+
+    friend std::ostream & operator<<(std::ostream & os, Xoshiro256StarStar const& generator) {
+        return os << generator.state[0] << " " << generator.state[1] << " "
+                  << generator.state[2] << " " << generator.state[3];
+    }
+
+    friend std::istream & operator>>(std::istream & is, Xoshiro256StarStar & generator) {
+        return is >> generator.state[0] >> generator.state[1] >> generator.state[2] >> generator.state[3];
+    }
+};
 
 
 //! A class implementation for RNG of normal and uniform distributions.
+//! It uses xoshiro256** by default; define `TRIANGLES_MT19937` to use `std::mt19937`.
 class Random {
+public:
+#ifdef TRIANGLES_MT19937
+    typedef std::mt19937 Engine;
+#else
+    typedef Xoshiro256StarStar Engine;
+#endif
 protected:
     unsigned int seed;	//!< seed of the rng
-    std::random_device rd;
-    std::mt19937 generator;
+    Engine generator;
     std::normal_distribution<> normal;
-    std::uniform_real_distribution<> uniform;
+
+    //! 32 random bits (the highest bits of xoshiro, which are its best ones).
+    inline uint32_t bits32() {
+#ifdef TRIANGLES_MT19937
+        return (uint32_t)generator();
+#else
+        return (uint32_t)(generator() >> 32);
+#endif
+    }
+
+    //! 53 random bits, the precision of a double.
+    inline uint64_t bits53() {
+#ifdef TRIANGLES_MT19937
+        uint64_t high = generator() >> 5;  // two calls, in a defined order
+        return (high << 26) | (generator() >> 6);
+#else
+        return generator() >> 11;
+#endif
+    }
+
+    static Engine engine(unsigned int seed, unsigned int stream) {
+#ifdef TRIANGLES_MT19937
+        if (stream == 0)
+            return Engine(seed);
+        std::seed_seq sequence{seed, stream};
+        return Engine(sequence);
+#else
+        Engine result(seed);
+        for (unsigned int i = 0; i < stream; i++)
+            result.jump();
+        return result;
+#endif
+    }
 public:
     //! Default constructor: uses a random seed
     Random() : seed(std::random_device{}()), generator(seed) {}
     //! Constructor: uses argument as the seed
     Random(unsigned int seed) : seed(seed), generator(seed) {};
+    //! Constructor of the substream `stream` of `seed`, e.g. for the walker `stream`
+    //! of a parallel sampler: the same (seed, stream) always gives the same sequence,
+    //! and different streams do not overlap (the generator jumps 2^128 calls per stream).
+    //! With `TRIANGLES_MT19937`, which cannot jump, streams are seeded by `std::seed_seq`
+    //! instead (except the stream 0) and are independent only in practice.
+    Random(unsigned int seed, unsigned int stream) : seed(seed), generator(engine(seed, stream)) {};
 
     unsigned int get_seed() const {
         return seed;
     };
 
-    //! returns an integer random number under uniform distribution on interval \f$[0,N[\f$
-    unsigned int R(unsigned int min, unsigned int max) {
-        return std::uniform_int_distribution<unsigned int>{min, max - 1}(generator);
+    //! returns an integer random number under uniform distribution on interval \f$[min,max[\f$.
+    //! Uses Lemire's multiply-and-reject method: unbiased and, almost always, without divisions.
+    inline unsigned int R(unsigned int min, unsigned int max) {
+        uint32_t range = max - min;
+        uint64_t product = (uint64_t)bits32()*range;
+        uint32_t low = (uint32_t)product;
+        if (low < range) {
+            uint32_t threshold = (uint32_t)(-range) % range;
+            while (low < threshold) {
+                product = (uint64_t)bits32()*range;
+                low = (uint32_t)product;
+            }
+        }
+        return min + (unsigned int)(product >> 32);
     }
-    //! returns a real random number under uniform distribution on interval \f$[0,1]\f$
-    long double R() {
-        return uniform(generator);
+    //! returns a real random number under uniform distribution on interval \f$[0,1[\f$
+    inline double R() {
+        return bits53()*(1.0/9007199254740992.0);
     }
     //! returns a real random number from a normal distribution on interval \f$[-\infty,\infty]\f$
-    long double normalR() {
+    double normalR() {
         return normal(generator);
     }
+
+    //! writes the state of the generator, such that `read` continues the same sequence.
+    void write(io::BinaryWriter & writer) const {
+        std::ostringstream state;
+        state << generator << " " << normal;
+        std::string text(state.str());
+        writer.write(seed);
+        writer.write(std::vector<char>(text.begin(), text.end()));
+    }
+
+    void read(io::BinaryReader & reader) {
+        seed = reader.read<unsigned int>();
+        std::vector<char> text(reader.read_vector<char>());
+        std::istringstream state(std::string(text.begin(), text.end()));
+        state >> generator >> normal;
+    }
 };
 
 #endif
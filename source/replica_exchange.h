@@ -0,0 +1,220 @@
+#ifndef triangles_replica_exchange_h
+#define triangles_replica_exchange_h
+
+#include <memory>
+
+#include "sampler.h"
+#include "parallel.h"
+
+
+//! Replica-exchange Wang-Landau: the range of triangles [lower, upper] is split
+//! in overlapping windows and each window is sampled by one or more
+//! `WangLandauSampler`s restricted to it, each with its own copy of the network.
+//! Walkers run in parallel for `exchange_interval` steps; then the walkers of
+//! each window average their entropy and perform a WL step if the sum of their
+//! histograms is flat; and then walkers of neighbouring windows exchange their
+//! networks. The entropies of the windows are stitched into a single entropy.
+//!
+//! Flatness is used instead of round-trips because the limits of a window may
+//! not be reachable: not every number of triangles exists (e.g. close to the maximum).
+class ReplicaExchangeWangLandau {
+protected:
+    typedef WangLandauWalker Walker;
+
+    unsigned int lower;
+    unsigned int upper;
+    unsigned int windows;
+    unsigned int walkers_per_window;
+
+    std::vector<unsigned int> window_lower;  // range of each window
+    std::vector<unsigned int> window_upper;
+    std::vector<std::unique_ptr<Walker> > walkers;  // walkers of window w: w*walkers_per_window, ...
+
+    Random rng;  // used for the exchanges
+    std::vector<unsigned long long> exchanges_proposed;  // between window w and w + 1
+    std::vector<unsigned long long> exchanges_accepted;
+
+    inline Walker & walker(unsigned int window, unsigned int index) {
+        return *walkers[window*walkers_per_window + index];
+    }
+
+    //! Whether the sum of the histograms of the walkers of a window is flat on its visited bins.
+    bool is_flat(unsigned int window, double flatness) {
+        Histogram<unsigned int> histogram(walker(window, 0).histogram);
+        for (unsigned int index = 1; index < walkers_per_window; index++)
+            histogram.merge(walker(window, index).histogram);
+        return histogram.is_flat(flatness, walker(window, 0).sampler.visited_bins());
+    }
+
+    //! Averages the entropy of the walkers of a window and performs a WL step
+    //! on all of them if their histogram is flat.
+    void window_step(unsigned int window, unsigned int total_steps, double flatness) {
+        std::vector<double> entropy(walker(window, 0).sampler.get_entropy());
+        for (unsigned int index = 1; index < walkers_per_window; index++) {
+            std::vector<double> const& walker_entropy = walker(window, index).sampler.get_entropy();
+            for (unsigned int bin = 0; bin < entropy.size(); bin++)
+                entropy[bin] += walker_entropy[bin];
+        }
+        for (unsigned int bin = 0; bin < entropy.size(); bin++)
+            entropy[bin] /= walkers_per_window;
+
+        bool flat = walker(window, 0).sampler.get_wl_step() < total_steps and is_flat(window, flatness);
+        for (unsigned int index = 0; index < walkers_per_window; index++) {
+            Walker & current = walker(window, index);
+            current.sampler.set_entropy(entropy);
+            if (flat) {
+                current.sampler.wang_landau_step();
+                current.histogram.reset();
+            }
+        }
+    }
+
+    //! tries to exchange the networks of a random walker of `window` and of `window + 1`.
+    void exchange(unsigned int window) {
+        Walker & walker_i = walker(window, rng.R(0, walkers_per_window));
+        Walker & walker_j = walker(window + 1, rng.R(0, walkers_per_window));
+        unsigned int triangles_i = walker_i.network.get_triangles();
+        unsigned int triangles_j = walker_j.network.get_triangles();
+
+        exchanges_proposed[window]++;
+        if (not walker_i.sampler.in_range(triangles_j) or not walker_j.sampler.in_range(triangles_i))
+            return;
+
+        double log_probability = walker_i.sampler.entropy_of(triangles_i) - walker_i.sampler.entropy_of(triangles_j) +
+                                 walker_j.sampler.entropy_of(triangles_j) - walker_j.sampler.entropy_of(triangles_i);
+        if (acceptance::metropolis(rng, log_probability)) {
+            std::swap(walker_i.network, walker_j.network);
+            exchanges_accepted[window]++;
+        }
+    }
+
+public:
+    //! `overlap` is the fraction of a window shared with the next window. Every
+    //! window must span at least `min_window_bins()` bins, or it exits.
+    ReplicaExchangeWangLandau(Network const& network, unsigned int lower, unsigned int upper,
+                              unsigned int windows, double overlap=0.75, unsigned int walkers_per_window=1,
+                              unsigned int seed=2) :
+    lower(lower), upper(upper), windows(windows), walkers_per_window(walkers_per_window),
+    window_lower(windows), window_upper(windows), rng(seed, 0),
+    exchanges_proposed(windows, 0), exchanges_accepted(windows, 0) {
+        assert(windows > 0 and walkers_per_window > 0 and overlap >= 0 and overlap < 1);
+
+        // windows of equal width where consecutive windows share `overlap` of it
+        double width = upper > lower ? (upper - lower)/(1 + (windows - 1)*(1 - overlap)) : 0;
+        if (width < min_window_bins()) {
+            std::cout << "the triangles [" << lower << ", " << upper << "] are too few for " << windows
+                      << " windows of at least " << min_window_bins() << " bins with overlap " << overlap << std::endl;
+            exit(1);
+        }
+        for (unsigned int window = 0; window < windows; window++) {
+            window_lower[window] = lower + (unsigned int)round(window*width*(1 - overlap));
+            window_upper[window] = window == windows - 1 ? upper :
+                                   lower + (unsigned int)round(window*width*(1 - overlap) + width);
+            for (unsigned int index = 0; index < walkers_per_window; index++)
+                walkers.push_back(std::unique_ptr<Walker>(new Walker(network, window_lower[window], window_upper[window],
+                                                                     seed, 1 + (unsigned int)walkers.size())));
+        }
+    }
+
+    //! the least bins of a window: a window of fewer has no range to walk in.
+    static unsigned int min_window_bins() {return 2;}
+
+    inline unsigned int get_windows() const {return windows;}
+    inline unsigned int get_window_lower(unsigned int window) const {return window_lower[window];}
+    inline unsigned int get_window_upper(unsigned int window) const {return window_upper[window];}
+
+    //! fraction of accepted exchanges between `window` and `window + 1`.
+    double exchange_acceptance(unsigned int window) const {
+        return exchanges_proposed[window] ? exchanges_accepted[window]*1./exchanges_proposed[window] : 0;
+    }
+
+    //! Runs until all windows performed `total_steps` WL steps.
+    void sample(unsigned int total_steps, double flatness=0.8, unsigned int exchange_interval=1000,
+                unsigned int threads=parallel::threads()) {
+        parallel::for_each((unsigned int)walkers.size(), [this](unsigned int index) {
+            walkers[index]->sampler.move_into_range();
+        }, threads);
+
+        unsigned int phase = 0;
+        while (true) {
+            bool finished = true;
+            for (unsigned int window = 0; window < windows; window++)
+                finished = finished and walker(window, 0).sampler.get_wl_step() >= total_steps;
+            if (finished)
+                break;
+
+            parallel::for_each((unsigned int)walkers.size(), [this, exchange_interval](unsigned int index) {
+                for (unsigned int step = 0; step < exchange_interval; step++)
+                    walkers[index]->sampler.markov_step();
+            }, threads);
+
+            for (unsigned int window = 0; window < windows; window++)
+                window_step(window, total_steps, flatness);
+
+            // alternate between the even and the odd pairs of windows
+            for (unsigned int window = phase % 2; window + 1 < windows; window += 2)
+                exchange(window);
+            phase++;
+        }
+    }
+
+    //! Stitches the entropies of the windows: each window is shifted to match the
+    //! previous one on average over their common visited triangles, and replaces
+    //! it from the middle of their overlap on. Returns the entropy of every number
+    //! of triangles in [lower, upper] (NAN where it was never visited), not normalized.
+    std::vector<double> entropy() const {
+        std::vector<double> result(upper - lower + 1, NAN);
+        for (unsigned int window = 0; window < windows; window++) {
+            WangLandauSampler const& sampler = walkers[window*walkers_per_window]->sampler;
+            std::vector<double> const& window_entropy = sampler.get_entropy();
+            auto visited = [&](unsigned int triangles) {return window_entropy[triangles - window_lower[window]] > 0;};
+
+            double shift = 0;
+            unsigned int common = 0;
+            for (unsigned int triangles = window_lower[window]; triangles <= window_upper[window]; triangles++)
+                if (visited(triangles) and not std::isnan(result[triangles - lower])) {
+                    shift += result[triangles - lower] - sampler.entropy_of(triangles);
+                    common++;
+                }
+            if (common)
+                shift /= common;
+            else if (window > 0)
+                std::cout << "window " << window << " does not overlap the previous one" << std::endl;
+
+            unsigned int start = window == 0 ? window_lower[window] :
+                                 (window_lower[window] + window_upper[window - 1] + 1)/2;
+            for (unsigned int triangles = window_lower[window]; triangles <= window_upper[window]; triangles++)
+                if (visited(triangles) and (triangles >= start or std::isnan(result[triangles - lower])))
+                    result[triangles - lower] = sampler.entropy_of(triangles) + shift;
+        }
+        return result;
+    }
+
+    //! exports the normalized stitched entropy, \sum(exp(S)) == 1, in the format
+    //! of `WangLandauSampler::export_entropy`.
+    void export_entropy(std::string file_name) const {
+        std::vector<double> S(entropy());
+
+        double S_max = -std::numeric_limits<double>::infinity();
+        for (double value : S)
+            if (not std::isnan(value) and value > S_max)
+                S_max = value;
+        double C = 0;
+        for (double value : S)
+            if (not std::isnan(value))
+                C += exp(value - S_max);
+        C = S_max + log(C);
+
+        std::vector<std::vector<double> > data;
+        for (unsigned int triangles = lower; triangles <= upper; triangles++)
+            if (not std::isnan(S[triangles - lower])) {
+                std::vector<double> row(2);
+                row[0] = triangles;
+                row[1] = S[triangles - lower] - C;
+                data.push_back(row);
+            }
+        io::save(data, file_name);
+    }
+};
+
+#endif
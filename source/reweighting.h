@@ -0,0 +1,229 @@
+#ifndef triangles_reweighting_h
+#define triangles_reweighting_h
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "io.h"
+#include "parallel.h"
+
+
+//! Reweighting of entropies and histograms into canonic averages, where the
+//! canonic distribution is p(t) = exp(S(t) + beta*t)/Z(beta). Entropies are in
+//! log-space, with NAN for unknown numbers of triangles, and sums are computed
+//! relative to their largest term, since S(t) + beta*t spans hundreds of units.
+namespace reweighting {
+
+    //! Entropy of a multicanonical run: it sampled with weights exp(-S(t)) and
+    //! visited t `histogram[t]` times, so its estimate of the entropy is
+    //! S(t) + log(histogram[t]), normalized to \sum(exp(S)) == 1.
+    template <class Counts>
+    std::vector<double> entropy(std::vector<double> const& weights, Counts const& histogram) {
+        std::vector<double> result(weights.size(), NAN);
+        double S_max = -std::numeric_limits<double>::infinity();
+        for (unsigned int t = 0; t < weights.size(); t++)
+            if (histogram[t] > 0) {
+                result[t] = weights[t] + log((double)histogram[t]);
+                S_max = std::max(S_max, result[t]);
+            }
+        double C = 0;
+        for (double value : result)
+            if (not std::isnan(value))
+                C += exp(value - S_max);
+        C = S_max + log(C);
+        for (double & value : result)
+            value -= C;
+        return result;
+    }
+
+    //! the canonic distribution p(t) at `beta` of the entropy S(t), where t is
+    //! `lower` + the index; 0 where the entropy is unknown.
+    inline std::vector<double> canonic_distribution(std::vector<double> const& entropy, double beta,
+                                                    unsigned int lower=0) {
+        std::vector<double> result(entropy.size(), 0);
+        double exponent_max = -std::numeric_limits<double>::infinity();
+        for (unsigned int t = 0; t < entropy.size(); t++)
+            if (not std::isnan(entropy[t]))
+                exponent_max = std::max(exponent_max, entropy[t] + beta*(lower + t));
+        double Z = 0;
+        for (unsigned int t = 0; t < entropy.size(); t++)
+            if (not std::isnan(entropy[t])) {
+                result[t] = exp(entropy[t] + beta*(lower + t) - exponent_max);
+                Z += result[t];
+            }
+        for (double & value : result)
+            value /= Z;
+        return result;
+    }
+
+    //! canonic average at `beta` of an observable with mean `values[t]` at each number of triangles
+    //! (e.g. from `BinObservables`); the numbers of triangles without a value (NAN) are ignored.
+    inline double canonic_average(std::vector<double> const& entropy, std::vector<double> const& values,
+                                  double beta, unsigned int lower=0) {
+        std::vector<double> p(canonic_distribution(entropy, beta, lower));
+        double sum = 0, norm = 0;
+        for (unsigned int t = 0; t < p.size(); t++)
+            if (p[t] > 0 and not std::isnan(values[t])) {
+                sum += p[t]*values[t];
+                norm += p[t];
+            }
+        return norm > 0 ? sum/norm : NAN;
+    }
+
+    //! canonic average of the number of triangles at `beta`.
+    inline double canonic_triangles(std::vector<double> const& entropy, double beta, unsigned int lower=0) {
+        std::vector<double> values(entropy.size());
+        for (unsigned int t = 0; t < values.size(); t++)
+            values[t] = lower + t;
+        return canonic_average(entropy, values, beta, lower);
+    }
+
+    //! Loads a file written by `export_entropy` (rows `t S(t)`) as a vector of
+    //! `size` entropies, NAN where the file has no row; with `size` 0, up to the last row.
+    inline std::vector<double> load_entropy(std::string file_name, unsigned int size=0) {
+        std::vector<std::vector<double> > data(io::load<double>(file_name));
+        if (size == 0)
+            for (std::vector<double> const& row : data)
+                size = std::max(size, (unsigned int)std::max(row[0] + 1, 0.));
+        std::vector<double> result(size, NAN);
+        for (std::vector<double> const& row : data) {
+            if (row.size() < 2 or row[0] < 0 or row[0] >= size) {
+                std::cout << "file \"" << file_name << "\" has a row out of the " << size << " bins" << std::endl;
+                exit(1);
+            }
+            result[(unsigned int)row[0]] = row[1];
+        }
+        return result;
+    }
+
+    //! log(Z), <t> and var(t) of the canonic distribution at each beta of `betas`.
+    struct CanonicCurves {
+        std::vector<double> betas;
+        std::vector<double> log_Z;
+        std::vector<double> mean;
+        std::vector<double> variance;
+
+        CanonicCurves(std::vector<double> const& betas) :
+        betas(betas), log_Z(betas.size()), mean(betas.size()), variance(betas.size()) {}
+
+        //! exports rows `beta log(Z) <t> var(t)`.
+        void export_curves(std::string file_name) const {
+            std::vector<std::vector<double> > data(betas.size());
+            for (unsigned int i = 0; i < betas.size(); i++)
+                data[i] = {betas[i], log_Z[i], mean[i], variance[i]};
+            io::save(data, file_name);
+        }
+    };
+
+    //! Evaluates canonic curves of an entropy at many betas. Each beta is a
+    //! log-sum-exp over the bins, relative to the largest exponent S(t) + beta*t;
+    //! the bins are grouped in blocks with a bound on their exponents, so that only
+    //! the blocks within `cutoff()` of the largest exponent are summed (the others
+    //! add less than the rounding error) and each sum is a plain loop over arrays.
+    class CanonicReweighting {
+    protected:
+        std::vector<double> t;  // the known bins, without NANs
+        std::vector<double> S;
+        std::vector<double> block_S_max;
+        std::vector<double> block_t_min;
+        std::vector<double> block_t_max;
+
+        static unsigned int block_size() {return 256;}
+        //! exp(-cutoff()) times a million bins is below the precision of a double.
+        static double cutoff() {return 60;}
+
+        inline unsigned int blocks() const {return (unsigned int)block_S_max.size();}
+        inline unsigned int begin(unsigned int block) const {return block*block_size();}
+        inline unsigned int end(unsigned int block) const {
+            return std::min((unsigned int)t.size(), (block + 1)*block_size());
+        }
+
+        //! the largest exponent S(t) + beta*t of a block, or a bound of it.
+        inline double bound(unsigned int block, double beta) const {
+            return block_S_max[block] + beta*(beta > 0 ? block_t_max[block] : block_t_min[block]);
+        }
+    public:
+        //! `entropy[i]` is S(lower + i), NAN where unknown.
+        CanonicReweighting(std::vector<double> const& entropy, unsigned int lower=0) {
+            for (unsigned int i = 0; i < entropy.size(); i++)
+                if (not std::isnan(entropy[i])) {
+                    t.push_back(lower + i);
+                    S.push_back(entropy[i]);
+                }
+            for (unsigned int block = 0; block*block_size() < t.size(); block++) {
+                block_S_max.push_back(*std::max_element(S.begin() + begin(block), S.begin() + end(block)));
+                block_t_min.push_back(t[begin(block)]);
+                block_t_max.push_back(t[end(block) - 1]);
+            }
+        }
+
+        //! log(Z), <t> and var(t) at `beta`.
+        void evaluate(double beta, double & log_Z, double & mean, double & variance) const {
+            if (t.empty()) {
+                log_Z = mean = variance = NAN;
+                return;
+            }
+            // the largest exponent, starting from the block with the largest bound
+            unsigned int first = 0;
+            for (unsigned int block = 1; block < blocks(); block++)
+                if (bound(block, beta) > bound(first, beta))
+                    first = block;
+            double x_max = -std::numeric_limits<double>::infinity();
+            double t_max = 0;
+            for (unsigned int b = 0; b < blocks(); b++) {
+                unsigned int block = (b + first) % blocks();
+                if (bound(block, beta) <= x_max)
+                    continue;
+                for (unsigned int i = begin(block); i < end(block); i++)
+                    if (S[i] + beta*t[i] > x_max) {
+                        x_max = S[i] + beta*t[i];
+                        t_max = t[i];
+                    }
+            }
+
+            // moments relative to the most probable t, which avoids cancellations in the variance
+            double sum_0 = 0, sum_1 = 0, sum_2 = 0;
+            for (unsigned int block = 0; block < blocks(); block++) {
+                if (bound(block, beta) < x_max - cutoff())
+                    continue;
+                double const* t_block = t.data() + begin(block);
+                double const* S_block = S.data() + begin(block);
+                unsigned int size = end(block) - begin(block);
+                for (unsigned int i = 0; i < size; i++) {
+                    double weight = exp(S_block[i] + beta*t_block[i] - x_max);
+                    double d = t_block[i] - t_max;
+                    sum_0 += weight;
+                    sum_1 += weight*d;
+                    sum_2 += weight*d*d;
+                }
+            }
+            log_Z = x_max + log(sum_0);
+            double d_mean = sum_1/sum_0;
+            mean = t_max + d_mean;
+            variance = std::max(sum_2/sum_0 - d_mean*d_mean, 0.);
+        }
+
+        //! evaluates every beta of `betas`, distributed over `threads` threads.
+        CanonicCurves curves(std::vector<double> const& betas, unsigned int threads=parallel::threads()) const {
+            CanonicCurves result(betas);
+            unsigned int chunk = 64;
+            parallel::for_each((unsigned int)(betas.size() + chunk - 1)/chunk, [&](unsigned int task) {
+                for (unsigned int i = task*chunk; i < std::min((unsigned int)betas.size(), (task + 1)*chunk); i++)
+                    evaluate(betas[i], result.log_Z[i], result.mean[i], result.variance[i]);
+            }, threads);
+            return result;
+        }
+    };
+
+    //! `count` betas evenly spaced in [beta_min, beta_max].
+    inline std::vector<double> linspace(double beta_min, double beta_max, unsigned int count) {
+        std::vector<double> result(count, beta_min);
+        for (unsigned int i = 1; i < count; i++)
+            result[i] = beta_min + i*(beta_max - beta_min)/(count - 1);
+        return result;
+    }
+}
+
+#endif
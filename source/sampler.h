@@ -4,79 +4,138 @@
 #include "histogram.h"
 #include "network.h"
 #include "proposer.h"
+#include "acceptance.h"
+#include "transition_matrix.h"
 #include "io.h"
 
+#include <chrono>
+#include <cstdio>  // for `rename`
 
-//! A generic sampler.
-class Sampler {
+
+//! The core of all samplers: a Markov chain on networks of type `NetworkType`
+//! with proposals of `ProposerType`, accepted with the rule `Acceptance`, that
+//! records into a `HistogramType`. Everything is resolved at compile time, so
+//! that the loops of the samplers inline the whole step. The "triangles" of the
+//! samplers are `network.get_motifs()`: the triangles of a `Network`, or any
+//! motif of a `MotifNetwork` (see motifs.h).
+template <class Acceptance, class NetworkType, class ProposerType, class HistogramType>
+class MarkovChainSampler {
 protected:
     Random & rng;
-    Histogram<unsigned int> & histogram;
-
+    HistogramType & histogram;
+    ProposerType proposer;
+    NetworkType & network;
+    Acceptance acceptance;
+    SamplerMetrics metrics;  // see metrics.h
 public:
-    Sampler(Random & rng,
-            Histogram<unsigned int> & histogram) : rng(rng), histogram(histogram) {}
+    MarkovChainSampler(Random & rng,
+                       HistogramType & histogram,
+                       NetworkType & network, Acceptance const& acceptance) :
+    rng(rng), histogram(histogram), proposer(rng), network(network), acceptance(acceptance) {}
+
+    //! the metrics of the sampler, which are only collected with `TRIANGLES_METRICS`.
+    inline SamplerMetrics const& get_metrics() const {return metrics;}
+    inline SamplerMetrics & get_metrics() {return metrics;}
+
+    //! exports the metrics of the sampler and its proposer to `prefix`.json and `prefix`.csv.
+    void export_metrics(std::string prefix) const {
+        metrics.export_json(prefix + ".json", proposer.get_metrics());
+        metrics.export_csv(prefix + ".csv");
+    }
+
+    //! proposes a move and applies it if accepted; returns whether it was accepted.
+    inline bool markov_step() {
+        return markov_step([](unsigned int, unsigned int) {});
+    }
+
+    //! Same, calling `observer(old_triangles, new_triangles)` with every proposal
+    //! before deciding on it (only if `Acceptance::uses_delta`).
+    template <class Observer>
+    inline bool markov_step(Observer const& observer) {
+        metrics.begin_step();
+        unsigned int old_triangles = network.get_motifs();
+        if (not Acceptance::uses_delta) {
+            proposer.propose(network);
+            metrics.lap(SamplerMetrics::APPLY);
+            metrics.end_step(old_triangles, true);
+            return true;
+        }
+
+        GeneratedProposal proposal = proposer.generate_proposal(network);
+        metrics.lap(SamplerMetrics::PROPOSAL);
+        unsigned int new_triangles = old_triangles + network.delta_motifs(proposal);
+        metrics.lap(SamplerMetrics::TRIANGLES);
+        observer(old_triangles, new_triangles);
+
+        bool was_accepted = acceptance.accept(rng, old_triangles, new_triangles);
+        metrics.lap(SamplerMetrics::ACCEPTANCE);
+        if (was_accepted) {
+            proposer.propose(network, proposal);
+            metrics.lap(SamplerMetrics::APPLY);
+        }
+        metrics.end_step(old_triangles, was_accepted);
+        if (metrics.export_due())
+            export_metrics(metrics.get_export_prefix());
+        return was_accepted;
+    }
 };
 
 
 //! Sampler that draws samples networks without weights
-class UniformSampler : public Sampler {
+template <class NetworkType=Network, class ProposerType=FixedDegreeProposer,
+          class HistogramType=Histogram<unsigned int> >
+class BasicUniformSampler : public MarkovChainSampler<UniformAcceptance, NetworkType, ProposerType, HistogramType> {
 protected:
-    FixedDegreeProposer proposer;
-    Network & network;
+    typedef MarkovChainSampler<UniformAcceptance, NetworkType, ProposerType, HistogramType> Base;
+    using Base::network;
+    using Base::histogram;
 public:
-    UniformSampler(Random & rng,
-                   Histogram<unsigned int> & histogram,
-                   Network & network) :
-    Sampler(rng, histogram), proposer(rng), network(network) {}
+    BasicUniformSampler(Random & rng,
+                        HistogramType & histogram,
+                        NetworkType & network) :
+    Base(rng, histogram, network, UniformAcceptance()) {}
 
     void sample(unsigned int total_samples) {
         // burn time: go to most probable network
-        while (network.get_triangles() != 0)
-            markov_step();
+        while (network.get_motifs() != 0)
+            this->markov_step();
         for (unsigned int sample = 0; sample < total_samples; sample++) {
-            markov_step();
-            histogram.add(network.get_triangles());
+            this->markov_step();
+            histogram.add(network.get_motifs());
         }
     }
-
-    virtual void markov_step() {
-        proposer.propose(network);
-    }
 };
 
+typedef BasicUniformSampler<> UniformSampler;
+
 
 //! Sampler that draws samples from the canonic distribution on the number of triangles
-class CanonicSampler : public UniformSampler {
+template <class NetworkType=Network, class ProposerType=FixedDegreeProposer,
+          class HistogramType=Histogram<unsigned int> >
+class BasicCanonicSampler : public MarkovChainSampler<CanonicAcceptance, NetworkType, ProposerType, HistogramType> {
 protected:
-    double beta;
+    typedef MarkovChainSampler<CanonicAcceptance, NetworkType, ProposerType, HistogramType> Base;
+    using Base::network;
+    using Base::histogram;
+    using Base::acceptance;
 public:
-    CanonicSampler(Random & rng,
-                   Histogram<unsigned int> & histogram,
-                   Network & network, double beta) :
-    UniformSampler(rng, histogram, network), beta(beta) {}
-
-    void markov_step() {
-        unsigned int old_triangles = network.get_triangles();
-
-        GeneratedProposal proposal = proposer.generate_proposal(network);
-        proposer.propose(network, proposal);
-
-        unsigned int new_triangles = network.get_triangles();
-
-        bool was_accepted = true;
-        // if rejected
-        if (rng.R() > exp(beta*(new_triangles - old_triangles))) {
-            proposer.rollback(network, proposal);
-            was_accepted = false;
-        }
-
+    BasicCanonicSampler(Random & rng,
+                        HistogramType & histogram,
+                        NetworkType & network, double beta) :
+    Base(rng, histogram, network, CanonicAcceptance(beta)) {}
+
+    inline void markov_step() {
+        unsigned int old_triangles = network.get_motifs();
+        Base::markov_step();
         histogram.add(old_triangles);
     }
 
+    inline double get_beta() const {return acceptance.get_beta();}
+    inline void set_beta(double new_beta) {acceptance.set_beta(new_beta);}
+
     void sample(unsigned int total_samples) {
         // burn time: go to most probable network
-        while (network.get_triangles() != 0)
+        while (network.get_motifs() != 0)
             markov_step();
 
         // Measure
@@ -87,59 +146,314 @@ public:
     }
 };
 
+typedef BasicCanonicSampler<> CanonicSampler;
+
 
 //! Sampler that computes the DOS of number of triangles using Wang-Landau algorithm
-class WangLandauSampler : public UniformSampler {
+template <class NetworkType=Network, class ProposerType=FixedDegreeProposer,
+          class HistogramType=Histogram<unsigned int> >
+class BasicWangLandauSampler :
+        public MarkovChainSampler<EntropyAcceptance<HistogramType>, NetworkType, ProposerType, HistogramType> {
+protected:
+    typedef MarkovChainSampler<EntropyAcceptance<HistogramType>, NetworkType, ProposerType, HistogramType> Base;
+    using Base::rng;
+    using Base::histogram;
+    using Base::proposer;
+    using Base::network;
+    using Base::acceptance;
+
     std::vector<double> entropy;
     double f;
-public:
-    WangLandauSampler(Random & rng,
-                      Histogram<unsigned int> & histogram,
-                      Network & network) :
-    UniformSampler(rng, histogram, network), entropy(histogram.bins() + 1), f(1) {}
 
-    void markov_step() {
-        unsigned int old_triangles = network.get_triangles();
+    unsigned int wl_step;     // number of finished WL steps (halvings of f)
+    unsigned int round_trip;  // number of finished round-trips in the current WL step
+    bool going_up;            // whether the current round-trip did not reach the highest bin yet
+    unsigned long long round_trip_start;  // Markov steps when the current round-trip started
+    double mean_round_trip;   // mean of the round-trip times of the current WL step
+    double m2_round_trip;     // sum of the squared deviations of those times from their mean
+
+    unsigned long long steps;  // number of Markov steps
+    bool one_over_t;           // whether to switch to the 1/t schedule (see `set_one_over_t`)
+    bool in_one_over_t;        // whether f follows 1/t already
+    unsigned int levels;       // number of visited bins when f started to follow 1/t
+
+    bool collecting;                      // whether proposals are collected (see `set_transition_matrix`)
+    bool hybrid;                          // whether WL steps restart from the TM entropy
+    TransitionMatrix transition_matrix;
+
+    std::string checkpoint_file;  // empty if no periodic checkpoints
+    double checkpoint_interval;   // in seconds
+    std::chrono::steady_clock::time_point last_checkpoint;
+
+    //! first 8 bytes of a checkpoint file.
+    static char const* checkpoint_format() {
+        return "TRIWL005";
+    }
 
-        GeneratedProposal proposal = proposer.generate_proposal(network);
-        proposer.propose(network, proposal);
+    //! steps between the checks of flatness in `sample_until`.
+    static unsigned int flatness_interval() {
+        return 1000;
+    }
+public:
+    BasicWangLandauSampler(Random & rng,
+                           HistogramType & histogram,
+                           NetworkType & network) :
+    Base(rng, histogram, network, EntropyAcceptance<HistogramType>(histogram, entropy)),
+    entropy(histogram.bins() + 1), f(1),
+    wl_step(0), round_trip(0), going_up(true), round_trip_start(0), mean_round_trip(0), m2_round_trip(0),
+    steps(0), one_over_t(false), in_one_over_t(false), levels(0),
+    collecting(false), hybrid(false), transition_matrix(histogram.bins() + 1), checkpoint_interval(0) {}
+
+    //! the acceptance refers to `entropy`, so a copy would accept against the entropy of the original.
+    BasicWangLandauSampler(BasicWangLandauSampler const&) = delete;
+    BasicWangLandauSampler & operator=(BasicWangLandauSampler const&) = delete;
+
+    inline void markov_step() {
+        if (collecting)
+            Base::markov_step([this](unsigned int old_triangles, unsigned int new_triangles) {
+                if (not in_range(old_triangles))
+                    return;
+                if (in_range(new_triangles))
+                    transition_matrix.add(histogram.bin(old_triangles), histogram.bin(new_triangles));
+                else
+                    transition_matrix.add_outside(histogram.bin(old_triangles));
+            });
+        else
+            Base::markov_step();
+        steps++;
+        if (in_one_over_t)
+            f = levels/(double)steps;
+        unsigned int bin = histogram.bin(network.get_motifs());
+        histogram.add(network.get_motifs());
+        entropy[bin] += f;
+        this->metrics.visit_bin(bin, histogram.bins());
+    }
 
-        unsigned int new_triangles = network.get_triangles();
+    //! whether a number of triangles is within the range of the histogram, where the walk is restricted to.
+    inline bool in_range(unsigned int triangles) const {
+        return acceptance.in_range(triangles);
+    }
 
-        bool was_accepted = true;
-        // if rejected
-        if (rng.R() > exp(entropy[old_triangles] - entropy[new_triangles])) {
-            proposer.rollback(network, proposal);
-            was_accepted = false;
-        }
+    //! entropy of a number of triangles in the range of the histogram.
+    inline double entropy_of(unsigned int triangles) const {
+        return entropy[histogram.bin(triangles)];
+    }
 
-        histogram.add(network.get_triangles());
-        entropy[histogram.bin(network.get_triangles())] += f;
+    //! Walks to the range of the histogram, accepting only proposals that do not move away from it.
+    void move_into_range() {
+        unsigned int lower = histogram.value(0), upper = histogram.value(histogram.bins());
+        auto distance = [lower, upper](unsigned int triangles) {
+            return triangles < lower ? lower - triangles : (triangles > upper ? triangles - upper : 0);
+        };
+        while (not in_range(network.get_motifs())) {
+            unsigned int old_triangles = network.get_motifs();
+            GeneratedProposal proposal = proposer.generate_proposal(network);
+            if (distance(old_triangles + network.delta_motifs(proposal)) <= distance(old_triangles))
+                proposer.propose(network, proposal);
+        }
     }
 
     inline void wang_landau_step() {
         f /= 2;
+        wl_step++;
+        round_trip = 0;
+        mean_round_trip = 0;
+        m2_round_trip = 0;
+
+        if (one_over_t and not in_one_over_t) {
+            unsigned int visited = 0;
+            for (double value : entropy)
+                visited += value > 0;
+            if (f < visited/(double)steps) {
+                in_one_over_t = true;
+                levels = visited;
+                f = levels/(double)steps;
+            }
+        }
+    }
+
+    //! a WL step of `sample_until`, with the histogram reset for the next one.
+    void end_wang_landau_step() {
+        if (hybrid)
+            use_transition_matrix_entropy();
+        wang_landau_step();
+        histogram.reset();
+    }
+
+    //! Belardinelli-Pereyra schedule: once f falls below 1/t, where t is the number
+    //! of steps per visited bin, f = 1/t from then on, which avoids the saturation
+    //! of the error of halving f.
+    inline void set_one_over_t(bool enabled) {one_over_t = enabled;}
+    inline bool get_in_one_over_t() const {return in_one_over_t;}
+    inline unsigned long long get_steps() const {return steps;}
+
+    //! the bins visited so far (where the entropy is not 0), e.g. for `Histogram::is_flat`.
+    std::vector<bool> visited_bins() const {
+        std::vector<bool> result(entropy.size());
+        for (unsigned int bin = 0; bin < entropy.size(); bin++)
+            result[bin] = entropy[bin] > 0;
+        return result;
+    }
+
+    //! Transition-matrix Monte Carlo alongside WL: every proposal, accepted or not,
+    //! is collected into a `TransitionMatrix`, whose estimate of the entropy does
+    //! not depend on the weights of sampling and thus does not saturate like WL.
+    //! With `hybrid`, each WL step (in `sample_until`) also restarts from that
+    //! estimate, so that WL samples with the better weights.
+    void set_transition_matrix(bool enabled, bool hybrid_steps=false) {
+        collecting = enabled;
+        hybrid = enabled and hybrid_steps;
+    }
+    inline TransitionMatrix const& get_transition_matrix() const {return transition_matrix;}
+
+    //! Replaces the entropy by the estimate of the transition matrix, shifted to
+    //! keep the visited bins positive and the others 0. Does nothing and returns
+    //! false if the transition matrix does not know every visited bin yet.
+    bool use_transition_matrix_entropy() {
+        std::vector<double> estimate(transition_matrix.entropy());
+        double S_min = std::numeric_limits<double>::infinity();
+        for (unsigned int bin = 0; bin < entropy.size(); bin++) {
+            if (entropy[bin] > 0 and std::isnan(estimate[bin]))
+                return false;
+            if (not std::isnan(estimate[bin]))
+                S_min = std::min(S_min, estimate[bin]);
+        }
+        if (std::isinf(S_min))
+            return false;
+        for (unsigned int bin = 0; bin < entropy.size(); bin++)
+            entropy[bin] = std::isnan(estimate[bin]) ? 0 : estimate[bin] - S_min + 1;
+        return true;
+    }
+
+    inline std::vector<double> const& get_entropy() const {return entropy;}
+    inline void set_entropy(std::vector<double> const& new_entropy) {
+        assert(new_entropy.size() == entropy.size());
+        entropy = new_entropy;
+    }
+    inline double get_f() const {return f;}
+    inline unsigned int get_wl_step() const {return wl_step;}
+    inline unsigned int get_round_trip() const {return round_trip;}
+
+    //! mean and variance of the times (in Markov steps) of the round-trips of the
+    //! current WL step; the first round-trip also counts the steps before it.
+    inline double get_mean_round_trip() const {return mean_round_trip;}
+    inline double get_variance_round_trip() const {return round_trip > 1 ? m2_round_trip/(round_trip - 1) : 0;}
+
+    //! Performs a Markov step and controls round-trips: from the lowest bin of the
+    //! histogram to the highest and back. Returns whether this step finished a round-trip.
+    bool round_trip_step() {
+        markov_step();
+        unsigned int triangles = network.get_motifs();
+
+        // round-trip control
+        if (histogram.bin(triangles) == histogram.bins()
+            and going_up) {
+            going_up = false;
+            //std::cout << "reached up\n";
+        }
+        else if (histogram.bin(triangles) == 0
+                 and not going_up) {
+            //std::cout << "reached down\n";
+            going_up = true;
+            round_trip++;
+
+            // update formula: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Online_algorithm
+            double time = (double)(steps - round_trip_start);
+            round_trip_start = steps;
+            double delta = time - mean_round_trip;
+            mean_round_trip += delta/round_trip;
+            m2_round_trip += delta*(time - mean_round_trip);
+            return true;
+        }
+        return false;
     }
 
     //! performs a round-trip.
     void perform_round_trip() {
-        bool going_up = true;
+        while (not round_trip_step()) {}
+    }
 
-        while (true) {
-            markov_step();
-            unsigned int triangles = network.get_triangles();
+    //! Saves everything needed to continue the simulation bit-for-bit: the network,
+    //! the histogram, the state of the rng, the entropy, f, the WL step and
+    //! round-trip counters, the statistics of the round-trip times and the setting
+    //! and state of the 1/t schedule. It writes to a temporary file that replaces
+    //! `file_name` at the end, so an interrupted save keeps the previous checkpoint.
+    void save_checkpoint(std::string file_name) const {
+        std::string temporary_file = file_name + ".tmp";
+        io::BinaryWriter writer(temporary_file);
+        writer.write_bytes(checkpoint_format(), 8);
+        network.write(writer);
+        histogram.write(writer);
+        rng.write(writer);
+        writer.write(entropy);
+        writer.write(f);
+        writer.write(wl_step);
+        writer.write(round_trip);
+        writer.write(going_up);
+        writer.write(round_trip_start);
+        writer.write(mean_round_trip);
+        writer.write(m2_round_trip);
+        writer.write(steps);
+        writer.write(one_over_t);
+        writer.write(in_one_over_t);
+        writer.write(levels);
+        writer.write(collecting);
+        writer.write(hybrid);
+        transition_matrix.write(writer);
+        writer.close();
+
+        if (rename(temporary_file.c_str(), file_name.c_str()) != 0) {
+            std::cout << "checkpoint \"" << file_name << "\" could not be written" << std::endl;
+            exit(1);
+        }
+    }
 
-            // round-trip control
-            if (histogram.bin(triangles) == histogram.bins()
-                and going_up) {
-                going_up = false;
-                //std::cout << "reached up\n";
-            }
-            else if (histogram.bin(triangles) == 0
-                     and not going_up) {
-                //std::cout << "reached down\n";
-                break;
-            }
+    //! Restores a checkpoint written by `save_checkpoint` on a sampler with the same histogram.
+    void load_checkpoint(std::string file_name) {
+        io::MappedFile file(file_name);
+        io::BinaryReader reader(file);
+        if (not reader.starts_with(checkpoint_format(), 8)) {
+            std::cout << "file \"" << file_name << "\" is not a checkpoint" << std::endl;
+            exit(1);
+        }
+        reader.read<unsigned long long>();  // the format
+        network.read(reader);
+        histogram.read(reader);
+        rng.read(reader);
+        std::vector<double> saved_entropy(reader.read_vector<double>());
+        assert(saved_entropy.size() == entropy.size());
+        entropy = saved_entropy;
+        f = reader.read<double>();
+        wl_step = reader.read<unsigned int>();
+        round_trip = reader.read<unsigned int>();
+        going_up = reader.read<bool>();
+        round_trip_start = reader.read<unsigned long long>();
+        mean_round_trip = reader.read<double>();
+        m2_round_trip = reader.read<double>();
+        steps = reader.read<unsigned long long>();
+        one_over_t = reader.read<bool>();
+        in_one_over_t = reader.read<bool>();
+        levels = reader.read<unsigned int>();
+        collecting = reader.read<bool>();
+        hybrid = reader.read<bool>();
+        transition_matrix.read(reader);
+    }
+
+    //! Makes `checkpoint_if_due` save a checkpoint to `file_name` every `interval` seconds.
+    void set_checkpoint(std::string file_name, double interval) {
+        checkpoint_file = file_name;
+        checkpoint_interval = interval;
+        last_checkpoint = std::chrono::steady_clock::now();
+    }
+
+    //! Saves a checkpoint if one is set and `interval` seconds passed since the last one.
+    void checkpoint_if_due() {
+        if (checkpoint_file.empty())
+            return;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<double>(now - last_checkpoint).count() >= checkpoint_interval) {
+            save_checkpoint(checkpoint_file);
+            last_checkpoint = now;
         }
     }
 
@@ -172,18 +486,191 @@ public:
         io::save(data, file_name);
     }
 
+    //! exports the normalized entropy of the transition matrix, in the format of
+    //! `export_entropy` (the bins it knows only).
+    void export_transition_matrix_entropy(std::string file_name) const {
+        std::vector<double> estimate(transition_matrix.entropy());
+        double S_max = -std::numeric_limits<double>::infinity();
+        for (double value : estimate)
+            if (not std::isnan(value) and value > S_max)
+                S_max = value;
+        double C = 0;
+        for (double value : estimate)
+            if (not std::isnan(value))
+                C += exp(value - S_max);
+        C = S_max + log(C);
+
+        std::vector<std::vector<double> > data;
+        for (unsigned int b = 0; b < estimate.size(); b++)
+            if (not std::isnan(estimate[b])) {
+                std::vector<double> row(2);
+                row[0] = b;
+                row[1] = estimate[b] - C;
+                data.push_back(row);
+            }
+        io::save(data, file_name);
+    }
+
+    //! Runs WL steps until `total_steps` finished; it continues from the counters
+    //! of a restored checkpoint and saves checkpoints if set (see `set_checkpoint`).
     void sample(unsigned int total_steps, unsigned int round_trips=5) {
-        for (unsigned int step = 0; step < total_steps; step++) {
-            std::cout << "w-l step: " << step + 1 << "/" << total_steps << std::endl;
-            histogram.reset();
-            for (unsigned int round_trip = 0; round_trip < round_trips; round_trip++)
+        while (wl_step < total_steps) {
+            std::cout << "w-l step: " << wl_step + 1 << "/" << total_steps << std::endl;
+            if (round_trip == 0)
+                histogram.reset();
+            while (round_trip < round_trips) {
                 perform_round_trip();
+                checkpoint_if_due();
+            }
             wang_landau_step();
 
             histogram.export_histogram("tmp.dat");
             export_entropy("entropy_tmp.dat");
             }
     }
+
+    //! Runs until f < `f_final`, instead of a fixed number of WL steps. Each WL
+    //! step ends after `round_trips` round-trips or, if `flatness` > 0, when the
+    //! histogram is flat on the visited bins (see `Histogram::is_flat`); with the
+    //! 1/t schedule (see `set_one_over_t`), f decreases every step once it started.
+    //! In the hybrid mode of `set_transition_matrix`, each WL step restarts from
+    //! the entropy of the transition matrix. It continues from a restored checkpoint and saves checkpoints if set.
+    //! It also stops once `max_steps` Markov steps were done in total, and can be called again to continue.
+    void sample_until(double f_final, unsigned int round_trips=5, double flatness=0,
+                      unsigned long long max_steps=std::numeric_limits<unsigned long long>::max()) {
+        while (f >= f_final and steps < max_steps) {
+            if (in_one_over_t)
+                markov_step();
+            else if (flatness > 0) {
+                for (unsigned int step = 0; step < flatness_interval(); step++)
+                    markov_step();
+                if (histogram.is_flat(flatness, visited_bins()))
+                    end_wang_landau_step();
+            }
+            else if (round_trip_step() and round_trip >= round_trips)
+                end_wang_landau_step();
+            checkpoint_if_due();
+        }
+    }
+};
+
+typedef BasicWangLandauSampler<> WangLandauSampler;
+
+
+//! Sampler restricted to a window of triangles, the range of its histogram, to
+//! generate networks with a given number of triangles: moves out of the window
+//! are rejected from their change of triangles, before touching the network.
+//! Inside the window, networks are sampled with weights exp(-S(t)); with S == 0
+//! (the default) they are uniform, and with S the entropy of the window (see
+//! `estimate_entropy`) every number of triangles is equally likely.
+template <class NetworkType=Network, class ProposerType=FixedDegreeProposer,
+          class HistogramType=Histogram<unsigned int> >
+class BasicWindowSampler :
+        public MarkovChainSampler<EntropyAcceptance<HistogramType>, NetworkType, ProposerType, HistogramType> {
+protected:
+    typedef MarkovChainSampler<EntropyAcceptance<HistogramType>, NetworkType, ProposerType, HistogramType> Base;
+    using Base::rng;
+    using Base::histogram;
+    using Base::proposer;
+    using Base::network;
+    using Base::acceptance;
+
+    std::vector<double> entropy;
+    unsigned int target_lower;  // the numbers of triangles of the networks `sample` emits
+    unsigned int target_upper;
+public:
+    BasicWindowSampler(Random & rng,
+                       HistogramType & histogram,
+                       NetworkType & network) :
+    Base(rng, histogram, network, EntropyAcceptance<HistogramType>(histogram, entropy)),
+    entropy(histogram.bins() + 1, 0),
+    target_lower(histogram.value(0)), target_upper(histogram.value(histogram.bins())) {}
+
+    //! the acceptance refers to `entropy`, so a copy would follow the weights of the original.
+    BasicWindowSampler(BasicWindowSampler const&) = delete;
+    BasicWindowSampler & operator=(BasicWindowSampler const&) = delete;
+
+    inline void markov_step() {
+        Base::markov_step();
+        histogram.add(network.get_motifs());
+    }
+
+    inline bool in_window(unsigned int triangles) const {
+        return acceptance.in_range(triangles);
+    }
+
+    //! Walks into the window, accepting only proposals that do not move away from it.
+    void move_into_window() {
+        unsigned int lower = histogram.value(0), upper = histogram.value(histogram.bins());
+        auto distance = [lower, upper](unsigned int triangles) {
+            return triangles < lower ? lower - triangles : (triangles > upper ? triangles - upper : 0);
+        };
+        while (not in_window(network.get_motifs())) {
+            unsigned int old_triangles = network.get_motifs();
+            GeneratedProposal proposal = proposer.generate_proposal(network);
+            if (distance(old_triangles + network.delta_motifs(proposal)) <= distance(old_triangles))
+                proposer.propose(network, proposal);
+        }
+    }
+
+    inline std::vector<double> const& get_entropy() const {return entropy;}
+    inline void set_entropy(std::vector<double> const& new_entropy) {
+        assert(new_entropy.size() == entropy.size());
+        entropy = new_entropy;
+    }
+
+    //! Sets the entropy of the window by Wang-Landau until f < `f_final`, with WL
+    //! steps ending when the histogram is `flatness` flat, such that `sample`
+    //! visits every number of triangles of the window equally.
+    void estimate_entropy(double f_final, double flatness=0.8) {
+        move_into_window();
+        BasicWangLandauSampler<NetworkType, ProposerType, HistogramType> wang_landau(rng, histogram, network);
+        wang_landau.sample_until(f_final, 5, flatness);
+        entropy = wang_landau.get_entropy();
+        histogram.reset();
+    }
+
+    //! makes `sample` emit only networks with triangles in [lower, upper] (the whole window by default).
+    void set_target(unsigned int lower, unsigned int upper) {
+        target_lower = lower;
+        target_upper = upper;
+    }
+
+    //! Calls `callback(network)` with `total_samples` networks in the target, each
+    //! at least `thinning` steps after the previous one, so they are decorrelated
+    //! (for `thinning` larger than the autocorrelation time).
+    template <class Callback>
+    void sample(unsigned int total_samples, unsigned int thinning, Callback const& callback) {
+        move_into_window();
+        unsigned int steps = 0;
+        for (unsigned int sample = 0; sample < total_samples;) {
+            markov_step();
+            steps++;
+            unsigned int triangles = network.get_motifs();
+            if (steps >= thinning and triangles >= target_lower and triangles <= target_upper) {
+                callback(static_cast<NetworkType const&>(network));
+                sample++;
+                steps = 0;
+            }
+        }
+    }
+};
+
+typedef BasicWindowSampler<> WindowSampler;
+
+
+//! A Wang-Landau walker that owns everything its sampler refers to, for the
+//! samplers that run several walkers in parallel.
+struct WangLandauWalker {
+    Network network;
+    Histogram<unsigned int> histogram;
+    Random rng;
+    WangLandauSampler sampler;
+
+    WangLandauWalker(Network const& network, unsigned int lower, unsigned int upper,
+                     unsigned int seed, unsigned int stream) :
+    network(network), histogram(lower, upper, upper - lower), rng(seed, stream),
+    sampler(rng, this->histogram, this->network) {}
 };
 
 #endif
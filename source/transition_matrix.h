@@ -0,0 +1,159 @@
+#ifndef triangles_transition_matrix_h
+#define triangles_transition_matrix_h
+
+#include <vector>
+#include <deque>
+#include <cmath>
+#include <algorithm>
+
+#include "io.h"
+
+
+//! Collection matrix of transition-matrix Monte Carlo (TMMC): C[i][j] counts the
+//! proposals from the bin i to the bin j, accepted or not. Since proposals are
+//! symmetric, the DOS satisfies detailed balance with the infinite-temperature
+//! transition probabilities T[i][j] = C[i][j]/sum_k C[i][k]:
+//!     S(j) - S(i) = log(T[i][j]) - log(T[j][i])
+//! for every pair of bins with transitions both ways, whatever the weights used to
+//! sample. `entropy` solves these equations by weighted least squares.
+//!
+//! Moves change the number of triangles by a small amount, so only a band of
+//! C is stored: C[i][i + delta] for |delta| <= `max_delta`, which grows when needed.
+class TransitionMatrix {
+protected:
+    unsigned int size;           // number of bins
+    unsigned int max_delta;
+    std::vector<double> counts;  // C[i][i + delta] at i*width() + max_delta + delta
+    std::vector<double> totals;  // proposals from each bin, including the ones out of the bins
+
+    inline unsigned int width() const {return 2*max_delta + 1;}
+
+    void widen(unsigned int new_max_delta) {
+        std::vector<double> new_counts(size*(2*new_max_delta + 1), 0);
+        for (unsigned int i = 0; i < size; i++)
+            for (unsigned int k = 0; k < width(); k++)
+                new_counts[i*(2*new_max_delta + 1) + new_max_delta - max_delta + k] = counts[i*width() + k];
+        counts.swap(new_counts);
+        max_delta = new_max_delta;
+    }
+public:
+    TransitionMatrix(unsigned int size=0, unsigned int max_delta=8) :
+    size(size), max_delta(max_delta), counts(size*(2*max_delta + 1), 0), totals(size, 0) {}
+
+    inline unsigned int bins() const {return size;}
+
+    //! a proposal from bin `from` to bin `to`.
+    inline void add(unsigned int from, unsigned int to) {
+        unsigned int delta = from > to ? from - to : to - from;
+        if (delta > max_delta)
+            widen(2*delta);
+        counts[from*width() + max_delta + to - from]++;
+        totals[from]++;
+    }
+
+    //! a proposal from bin `from` to a state out of the bins (e.g. of a restricted range).
+    inline void add_outside(unsigned int from) {
+        totals[from]++;
+    }
+
+    //! number of proposals from bin i to bin j.
+    double operator()(unsigned int i, unsigned int j) const {
+        unsigned int delta = i > j ? i - j : j - i;
+        if (delta > max_delta)
+            return 0;
+        return counts[i*width() + max_delta + j - i];
+    }
+
+    //! estimate of the transition probability from bin i to bin j.
+    double probability(unsigned int i, unsigned int j) const {
+        return totals[i] > 0 ? (*this)(i, j)/totals[i] : 0;
+    }
+
+    void reset() {
+        std::fill(counts.begin(), counts.end(), 0);
+        std::fill(totals.begin(), totals.end(), 0);
+    }
+
+    //! Estimate of the entropy of each bin, up to a constant, or NAN for the bins
+    //! not connected, through transitions both ways, to the most visited bin.
+    //! Each pair (i, j) contributes an equation weighted by 1/(1/C[i][j] + 1/C[j][i]),
+    //! the inverse of the variance of its right-hand side; the equations are solved
+    //! by Gauss-Seidel starting from a spanning tree, that is already close.
+    std::vector<double> entropy(unsigned int sweeps=1000) const {
+        std::vector<double> S(size, NAN);
+        if (size == 0)
+            return S;
+        unsigned int root = 0;
+        for (unsigned int i = 1; i < size; i++)
+            if (totals[i] > totals[root])
+                root = i;
+        if (totals[root] == 0)
+            return S;
+
+        // differences of entropy between neighbouring bins, and their weights
+        auto connected = [this](unsigned int i, unsigned int j) {
+            return (*this)(i, j) > 0 and (*this)(j, i) > 0;
+        };
+        auto difference = [this](unsigned int i, unsigned int j) {
+            return log(probability(i, j)) - log(probability(j, i));
+        };
+        auto weight = [this](unsigned int i, unsigned int j) {
+            return 1/(1/(*this)(i, j) + 1/(*this)(j, i));
+        };
+        auto neighbours = [this](unsigned int i, unsigned int & first, unsigned int & last) {
+            first = i > max_delta ? i - max_delta : 0;
+            last = std::min(size - 1, i + max_delta);
+        };
+
+        // spanning tree by breadth-first search from the root
+        std::deque<unsigned int> queue(1, root);
+        S[root] = 0;
+        while (not queue.empty()) {
+            unsigned int i = queue.front(), first, last;
+            queue.pop_front();
+            neighbours(i, first, last);
+            for (unsigned int j = first; j <= last; j++)
+                if (j != i and std::isnan(S[j]) and connected(i, j)) {
+                    S[j] = S[i] + difference(i, j);
+                    queue.push_back(j);
+                }
+        }
+
+        for (unsigned int sweep = 0; sweep < sweeps; sweep++) {
+            double change = 0;
+            for (unsigned int i = 0; i < size; i++) {
+                if (std::isnan(S[i]) or i == root)
+                    continue;
+                unsigned int first, last;
+                neighbours(i, first, last);
+                double sum = 0, weights = 0;
+                for (unsigned int j = first; j <= last; j++)
+                    if (j != i and not std::isnan(S[j]) and connected(i, j)) {
+                        sum += weight(i, j)*(S[j] - difference(i, j));
+                        weights += weight(i, j);
+                    }
+                change = std::max(change, fabs(sum/weights - S[i]));
+                S[i] = sum/weights;
+            }
+            if (change < 1e-12)
+                break;
+        }
+        return S;
+    }
+
+    void write(io::BinaryWriter & writer) const {
+        writer.write(size);
+        writer.write(max_delta);
+        writer.write(counts);
+        writer.write(totals);
+    }
+
+    void read(io::BinaryReader & reader) {
+        size = reader.read<unsigned int>();
+        max_delta = reader.read<unsigned int>();
+        counts = reader.read_vector<double>();
+        totals = reader.read_vector<double>();
+    }
+};
+
+#endif
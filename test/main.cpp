@@ -2,6 +2,15 @@
 
 #include "test_system.h"
 #include "test_histogram.h"
+#include "test_link_list.h"
+#include "test_intersection.h"
+#include "test_io.h"
+#include "test_sampler.h"
+#include "test_random.h"
+#include "test_reweighting.h"
+#include "test_metrics.h"
+#include "test_enumeration.h"
+#include "test_motifs.h"
 
 
 int main(int argc, char **argv) {
@@ -0,0 +1,68 @@
+#ifndef triangles_test_enumeration_h
+#define triangles_test_enumeration_h
+
+#include "gtest/gtest.h"
+#include "enumeration.h"
+
+
+//! the graphs of every subset of links of `degrees.size()` nodes with the degrees, per number of triangles.
+std::vector<long double> brute_force_counts(std::vector<unsigned int> const& degrees) {
+    unsigned int nodes = (unsigned int)degrees.size();
+    std::vector<std::pair<unsigned int, unsigned int> > pairs;
+    for (unsigned int i = 0; i < nodes; i++)
+        for (unsigned int j = i + 1; j < nodes; j++)
+            pairs.push_back(std::make_pair(i, j));
+
+    std::vector<long double> counts(nodes*nodes*nodes, 0);
+    for (unsigned int subset = 0; subset < (1u << pairs.size()); subset++) {
+        std::vector<std::vector<bool> > linked(nodes, std::vector<bool>(nodes, false));
+        std::vector<unsigned int> degree(nodes, 0);
+        for (unsigned int k = 0; k < pairs.size(); k++)
+            if ((subset >> k) & 1) {
+                linked[pairs[k].first][pairs[k].second] = linked[pairs[k].second][pairs[k].first] = true;
+                degree[pairs[k].first]++;
+                degree[pairs[k].second]++;
+            }
+        if (degree != degrees)
+            continue;
+        unsigned int triangles = 0;
+        for (unsigned int i = 0; i < nodes; i++)
+            for (unsigned int j = i + 1; j < nodes; j++)
+                for (unsigned int k = j + 1; k < nodes; k++)
+                    triangles += linked[i][j] and linked[j][k] and linked[i][k];
+        counts[triangles]++;
+    }
+    return counts;
+}
+
+
+TEST(ExactEnumerator, brute_force) {
+    std::vector<std::vector<unsigned int> > sequences = {
+        {1, 1, 1, 1, 1, 1}, {2, 2, 2, 2, 2, 2}, {3, 3, 2, 2, 1, 1}, {4, 3, 3, 2, 2, 2}, {5, 1, 1, 1, 1, 1},
+        {5, 5, 1, 1, 1, 1},  // not graphical
+    };
+    for (std::vector<unsigned int> const& degrees : sequences) {
+        ExactEnumerator enumerator(degrees);
+        enumerator.enumerate(2);
+        std::vector<long double> expected(brute_force_counts(degrees));
+        for (unsigned int t = 0; t < enumerator.get_counts().size(); t++)
+            EXPECT_EQ(expected[t], enumerator.get_counts()[t]);
+    }
+}
+
+
+TEST(ExactEnumerator, cubic_graphs) {
+    // the labelled cubic graphs of 8 and 12 nodes (OEIS A002829)
+    ExactEnumerator enumerator(FixedDegreeNetwork(3, 2));
+    enumerator.enumerate(2);
+    EXPECT_EQ(19355, enumerator.total());
+    // two K4s are the only graphs with 8 triangles, one per split of the nodes in two halves
+    EXPECT_EQ(35, enumerator.get_counts()[8]);
+    EXPECT_NEAR(log(35/19355.), enumerator.entropy()[8], 1e-12);
+
+    ExactEnumerator larger(FixedDegreeNetwork(3, 3));
+    larger.enumerate(2);
+    EXPECT_EQ(11555272575.L, larger.total());
+}
+
+#endif
@@ -63,4 +63,36 @@ TEST(Histogram, floatUniform) {
     EXPECT_NEAR(0.5, histogram.value(histogram.bin(0.5999999)), 0.00001);
 }
 
+TEST(Histogram, logarithmic) {
+    Histogram<double, LogarithmicBinning> histogram(1, 1000, 3);
+
+    ASSERT_EQ(0, histogram.bin(1));
+    ASSERT_EQ(0, histogram.bin(9.9));
+    ASSERT_EQ(1, histogram.bin(10.1));
+    ASSERT_EQ(2, histogram.bin(999));
+    ASSERT_EQ(3, histogram.bin(1000));
+
+    EXPECT_NEAR(10, histogram.value(1), 0.00001);
+    EXPECT_NEAR(100, histogram.value(2), 0.00001);
+}
+
+TEST(Histogram, flatness) {
+    Histogram<unsigned int> histogram(0, 4, 4);
+    EXPECT_FALSE(histogram.is_flat(0.8));
+    for (unsigned int value = 0; value < 4; value++)
+        for (unsigned int i = 0; i < 10; i++)
+            histogram.add(value);
+    histogram.add(0);
+    // the bin of 4 is not visited
+    EXPECT_TRUE(histogram.is_flat(0.8));
+    EXPECT_FALSE(histogram.is_flat(0.8, {true, true, true, true, true}));
+    EXPECT_FALSE(histogram.is_flat(1.));
+
+    Histogram<unsigned int> other(0, 4, 4);
+    other.add(3);
+    histogram.merge(other);
+    EXPECT_EQ(42, histogram.count());
+    EXPECT_EQ(11, histogram[3]);
+}
+
 #endif
@@ -0,0 +1,52 @@
+#ifndef triangles_test_intersection_h
+#define triangles_test_intersection_h
+
+#include "gtest/gtest.h"
+#include "intersection.h"
+#include "random.h"
+#include <set>
+#include <vector>
+
+
+TEST(Intersection, kernels) {
+    Random rng(1);
+
+    for (unsigned int trial = 0; trial < 200; trial++) {
+        std::set<unsigned int> set_a, set_b;
+        unsigned int size_a = rng.R(0, 100), size_b = rng.R(0, 100), range = rng.R(1, 300);
+        for (unsigned int i = 0; i < size_a; i++)
+            set_a.insert(rng.R(0, range));
+        for (unsigned int i = 0; i < size_b; i++)
+            set_b.insert(rng.R(0, range));
+        std::vector<unsigned int> a(set_a.begin(), set_a.end()), b(set_b.begin(), set_b.end());
+
+        std::vector<unsigned int> expected;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+        std::vector<unsigned int> out(std::min(a.size(), b.size()));
+        ASSERT_EQ(expected.size(), intersection::count(a.data(), a.size(), b.data(), b.size()));
+        ASSERT_EQ(expected.size(), intersection::intersect(a.data(), a.size(), b.data(), b.size(), out.data()));
+        out.resize(expected.size());
+        ASSERT_EQ(expected, out);
+#ifdef TRIANGLES_X86_SIMD
+        if (__builtin_cpu_supports("sse4.2")) {
+            ASSERT_EQ(expected.size(), intersection::count_sse42(a.data(), a.size(), b.data(), b.size()));
+            std::vector<unsigned int> out_sse42(std::min(a.size(), b.size()));
+            ASSERT_EQ(expected.size(), intersection::intersect_sse42(a.data(), a.size(), b.data(), b.size(),
+                                                                     out_sse42.data()));
+            out_sse42.resize(expected.size());
+            ASSERT_EQ(expected, out_sse42);
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            ASSERT_EQ(expected.size(), intersection::count_avx2(a.data(), a.size(), b.data(), b.size()));
+            std::vector<unsigned int> out_avx2(std::min(a.size(), b.size()));
+            ASSERT_EQ(expected.size(), intersection::intersect_avx2(a.data(), a.size(), b.data(), b.size(),
+                                                                    out_avx2.data()));
+            out_avx2.resize(expected.size());
+            ASSERT_EQ(expected, out_avx2);
+        }
+#endif
+    }
+}
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef triangles_test_io_h
+#define triangles_test_io_h
+
+#include "gtest/gtest.h"
+#include "io.h"
+#include "network.h"
+#include "proposer.h"
+
+
+TEST(IO, read_edges) {
+    std::ofstream file("test_edges.dat");
+    file << "# a comment\n1 2\n2\t3 0.5\n% another comment\n\n3,1\r\n 4 ,  1\n1 1\n2 1";
+    file.close();
+
+    std::vector<std::pair<unsigned int, unsigned int> > edges;
+    io::ParseStatistics statistics = io::read_edges("test_edges.dat", [&](unsigned int node_i, unsigned int node_j) {
+        edges.push_back(std::make_pair(node_i, node_j));
+    });
+
+    ASSERT_EQ(6, edges.size());
+    EXPECT_EQ(std::make_pair(1u, 2u), edges[0]);
+    EXPECT_EQ(std::make_pair(2u, 3u), edges[1]);
+    EXPECT_EQ(std::make_pair(3u, 1u), edges[2]);
+    EXPECT_EQ(std::make_pair(4u, 1u), edges[3]);
+    EXPECT_EQ(std::make_pair(2u, 1u), edges[5]);
+    EXPECT_EQ(9, statistics.lines);
+    EXPECT_EQ(6, statistics.edges);
+
+    // repeated links and self-links are ignored
+    Network network("test_edges.dat");
+    ASSERT_EQ(4, network.getN());
+    EXPECT_EQ(4, network.get_links_count());
+    EXPECT_EQ(1, network.get_triangles());
+    std::remove("test_edges.dat");
+}
+
+
+TEST(IO, read_edges_range) {
+    // the largest node id is read as such, and larger ones are invalid instead of wrapping around
+    std::ofstream("test_edges.dat") << "4294967295 1\n1 2\n2 4294967295\n";
+    Network network("test_edges.dat");
+    EXPECT_EQ(3, network.getN());
+    EXPECT_EQ(1, network.get_triangles());
+
+    std::ofstream("test_edges.dat") << "1 2\n4294967296 1\n";
+    EXPECT_EXIT(io::read_edges("test_edges.dat", [](unsigned int, unsigned int) {}),
+                ::testing::ExitedWithCode(1), "");
+    std::ofstream("test_edges.dat") << "1 123456789012345678901234567890\n";
+    EXPECT_EXIT(io::read_edges("test_edges.dat", [](unsigned int, unsigned int) {}),
+                ::testing::ExitedWithCode(1), "");
+    std::remove("test_edges.dat");
+}
+
+
+TEST(IO, binary_network) {
+    Network network("examples/input_network.dat");
+    Random rng(1);
+    FixedDegreeProposer proposer(rng);
+    for (unsigned int i = 0; i < 10; i++)
+        proposer.propose(network, proposer.generate_proposal(network));
+    network.save_binary("test_network.bin");
+
+    Network loaded("test_network.bin");
+    ASSERT_EQ(network.getN(), loaded.getN());
+    ASSERT_EQ(network.get_triangles(), loaded.get_triangles());
+    ASSERT_EQ(network.get_links_count(), loaded.get_links_count());
+    for (unsigned int node_i = 0; node_i < network.getN(); node_i++) {
+        EXPECT_EQ(network.get_links(node_i), loaded.get_links(node_i));
+        EXPECT_EQ(network.get_node_triangles(node_i), loaded.get_node_triangles(node_i));
+    }
+    for (unsigned int index = 0; index < network.get_links_count(); index++)
+        EXPECT_EQ(network.get_link(index), loaded.get_link(index));
+
+    // the loaded network is a valid network
+    for (unsigned int i = 0; i < 100; i++) {
+        GeneratedProposal proposal = proposer.generate_proposal(loaded);
+        int triangles = loaded.get_triangles() + loaded.delta_triangles(proposal);
+        proposer.propose(loaded, proposal);
+        ASSERT_EQ(triangles, (int)loaded.get_triangles());
+    }
+    std::remove("test_network.bin");
+}
+
+
+TEST(IO, binary_network_corrupt) {
+    Network network("examples/input_network.dat");
+    network.save_binary("test_network.bin");
+    std::ifstream file("test_network.bin", std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    // the format, N, and then the N + 1 offsets and the links, at multiples of 8 bytes
+    size_t offsets = 16;
+    size_t all_links = offsets + 8*(network.getN() + 1);
+    auto load_modified = [&](std::string const& modified) {
+        std::ofstream("test_corrupt.bin", std::ios::binary) << modified;
+        Network loaded("test_corrupt.bin");
+    };
+
+    EXPECT_EXIT(load_modified(bytes.substr(0, bytes.size()/2)), ::testing::ExitedWithCode(1), "");
+
+    std::string modified(bytes);
+    unsigned long long offset = 1ull << 40;  // beyond the file and larger than the next offset
+    memcpy(&modified[offsets + 8], &offset, 8);
+    EXPECT_EXIT(load_modified(modified), ::testing::ExitedWithCode(1), "");
+
+    modified = bytes;
+    unsigned int node = network.getN();
+    memcpy(&modified[all_links], &node, 4);
+    EXPECT_EXIT(load_modified(modified), ::testing::ExitedWithCode(1), "");
+
+    modified = bytes;
+    modified[bytes.size() - 4] ^= 1;  // the shift of the link index
+    EXPECT_EXIT(load_modified(modified), ::testing::ExitedWithCode(1), "");
+
+    load_modified(bytes);
+    std::remove("test_network.bin");
+    std::remove("test_corrupt.bin");
+}
+
+#endif
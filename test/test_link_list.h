@@ -0,0 +1,33 @@
+#ifndef triangles_test_link_list_h
+#define triangles_test_link_list_h
+
+#include "gtest/gtest.h"
+#include "link_list.h"
+#include <set>
+
+
+TEST(SortedLinkList, set_interface) {
+    std::set<unsigned int> reference;
+    reference.insert(5);
+    reference.insert(1);
+    reference.insert(3);
+
+    SortedLinkList list(reference.begin(), reference.end());
+    ASSERT_EQ(3, list.size());
+    ASSERT_TRUE(std::equal(list.begin(), list.end(), reference.begin()));
+
+    list.insert(4);
+    list.insert(4);
+    ASSERT_EQ(4, list.size());
+    EXPECT_EQ(1, list.count(4));
+    EXPECT_EQ(0, list.count(2));
+    EXPECT_EQ(4, list[2]);
+
+    list.erase(1);
+    list.erase(2);
+    ASSERT_EQ(3, list.size());
+    EXPECT_EQ(3, list[0]);
+    EXPECT_EQ(0, list.count(1));
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef triangles_test_metrics_h
+#define triangles_test_metrics_h
+
+#include "gtest/gtest.h"
+#include "sampler.h"
+
+
+#ifdef TRIANGLES_METRICS
+
+TEST(Metrics, wang_landau) {
+    FixedDegreeNetwork network(3, 4);
+    Histogram<unsigned int> histogram(0, network.get_triangles(), network.get_triangles());
+    Random rng(2);
+    WangLandauSampler sampler(rng, histogram, network);
+    sampler.sample_until(1e-2, 5, 0.8);
+
+    SamplerMetrics const& metrics = sampler.get_metrics();
+    EXPECT_EQ(sampler.get_steps(), metrics.get_steps());
+    EXPECT_GT(metrics.steps_per_second(), 0);
+    EXPECT_GT(metrics.acceptance(0), 0);
+    EXPECT_LE(metrics.acceptance(0), 1);
+
+    // every round-trip has two tunnellings, and is at least as long as them
+    EXPECT_GT(metrics.get_round_trips().count, 0);
+    EXPECT_GE(metrics.get_tunnelling().count, 2*metrics.get_round_trips().count);
+    EXPECT_GE(metrics.get_round_trips().mean(), metrics.get_tunnelling().mean());
+
+    double total = 0;
+    for (unsigned int phase = 0; phase < SamplerMetrics::PHASES; phase++)
+        total += metrics.time_fraction(phase);
+    EXPECT_NEAR(1, total, 1e-9);
+}
+
+#else
+
+TEST(Metrics, disabled) {
+    // without TRIANGLES_METRICS the metrics are empty classes
+    EXPECT_FALSE(SamplerMetrics::enabled);
+    EXPECT_TRUE(std::is_empty<SamplerMetrics>::value);
+    EXPECT_TRUE(std::is_empty<ProposerMetrics>::value);
+}
+
+#endif
+
+#endif
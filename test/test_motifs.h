@@ -0,0 +1,91 @@
+#ifndef triangles_test_motifs_h
+#define triangles_test_motifs_h
+
+#include "gtest/gtest.h"
+#include "motifs.h"
+#include "sampler.h"
+
+
+//! a network of 24 nodes of degree 5 with some of every motif, after a few random swaps of blocks of 6 nodes.
+Network motifs_network() {
+    FixedDegreeNetwork network(5, 4);
+    Random rng(3);
+    FixedDegreeProposer proposer(rng);
+    for (unsigned int step = 0; step < 6; step++)
+        proposer.propose(network);
+    return network;
+}
+
+//! the squares and 4-cliques of every set of four nodes.
+void brute_force_motifs(Network const& network, unsigned int & squares, unsigned int & cliques) {
+    auto linked = [&network](unsigned int i, unsigned int j) {return network.get_links(i).count(j) == 1;};
+    squares = cliques = 0;
+    unsigned int N = network.getN();
+    for (unsigned int a = 0; a < N; a++)
+        for (unsigned int b = a + 1; b < N; b++)
+            for (unsigned int c = b + 1; c < N; c++)
+                for (unsigned int d = c + 1; d < N; d++) {
+                    // the three cycles a-b-c-d, a-b-d-c and a-c-b-d
+                    squares += linked(a, b) and linked(b, c) and linked(c, d) and linked(d, a);
+                    squares += linked(a, b) and linked(b, d) and linked(d, c) and linked(c, a);
+                    squares += linked(a, c) and linked(c, b) and linked(b, d) and linked(d, a);
+                    cliques += linked(a, b) and linked(a, c) and linked(a, d) and
+                               linked(b, c) and linked(b, d) and linked(c, d);
+                }
+}
+
+//! random swaps: `delta_motifs` is the change of the count from scratch, which `get_motifs` follows.
+template <class Counter>
+void check_incremental(Network const& initial) {
+    MotifNetwork<Counter> network(initial);
+    Random rng(1);
+    FixedDegreeProposer proposer(rng);
+    for (unsigned int step = 0; step < 500; step++) {
+        unsigned int before = network.get_motifs();
+        GeneratedProposal proposal = proposer.generate_proposal(network);
+        int delta = network.delta_motifs(proposal);
+        ASSERT_EQ(before, Counter::count(network)) << Counter::name();
+        proposer.propose(network, proposal);
+        ASSERT_EQ((int)Counter::count(network), (int)before + delta) << Counter::name();
+        ASSERT_EQ(Counter::count(network), network.get_motifs()) << Counter::name();
+    }
+    // the triangles of the network are still updated
+    std::vector<std::set<unsigned int> > links(network.getN());
+    for (unsigned int node_i = 0; node_i < network.getN(); node_i++)
+        links[node_i].insert(network.get_links(node_i).begin(), network.get_links(node_i).end());
+    EXPECT_EQ(Network(network.getN(), links).get_triangles(), network.get_triangles());
+}
+
+
+TEST(Motifs, counters) {
+    Network network(motifs_network());
+    unsigned int squares, cliques;
+    brute_force_motifs(network, squares, cliques);
+    EXPECT_LT(0, squares);
+    EXPECT_LT(0, cliques);
+    EXPECT_EQ(squares, SquareCounter::count(network));
+    EXPECT_EQ(cliques, CliqueCounter::count(network));
+    EXPECT_EQ(24*5*4/2, WedgeCounter::count(network));
+
+    check_incremental<TriangleCounter>(network);
+    check_incremental<WedgeCounter>(network);
+    check_incremental<SquareCounter>(network);
+    check_incremental<CliqueCounter>(network);
+}
+
+
+TEST(Motifs, wang_landau) {
+    // K4 blocks have 3 squares each; the walk is restricted to at most as many
+    MotifNetwork<SquareCounter> network(FixedDegreeNetwork(3, 4));
+    ASSERT_EQ(12, network.get_motifs());
+    Histogram<unsigned int> histogram(0, 12, 12);
+    Random rng(2);
+    BasicWangLandauSampler<MotifNetwork<SquareCounter> > sampler(rng, histogram, network);
+    for (unsigned int i = 0; i < 3; i++)
+        sampler.perform_round_trip();
+    EXPECT_EQ(SquareCounter::count(network), network.get_motifs());
+    EXPECT_LT(0, histogram[0]);
+    EXPECT_LT(0, histogram[12]);
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef triangles_test_random_h
+#define triangles_test_random_h
+
+#include "gtest/gtest.h"
+#include "random.h"
+#include <set>
+
+
+TEST(Random, streams) {
+    // the stream 0 is the sequence of the seed
+    Random rng(7), stream_0(7, 0);
+    for (unsigned int i = 0; i < 100; i++)
+        EXPECT_EQ(rng.R(0, 1000000), stream_0.R(0, 1000000));
+
+    // the same (seed, stream) gives the same sequence, and different streams differ
+    std::set<std::vector<unsigned int> > sequences;
+    for (unsigned int stream = 0; stream < 8; stream++) {
+        Random first(7, stream), second(7, stream);
+        std::vector<unsigned int> sequence;
+        for (unsigned int i = 0; i < 10; i++) {
+            sequence.push_back(first.R(0, 1000000));
+            EXPECT_EQ(sequence.back(), second.R(0, 1000000));
+        }
+        sequences.insert(sequence);
+    }
+    EXPECT_EQ(8, sequences.size());
+}
+
+TEST(Random, bounded) {
+    Random rng(3);
+    std::vector<unsigned int> counts(7, 0);
+    for (unsigned int i = 0; i < 70000; i++) {
+        unsigned int value = rng.R(10, 17);
+        ASSERT_GE(value, 10);
+        ASSERT_LT(value, 17);
+        counts[value - 10]++;
+    }
+    for (unsigned int count : counts)
+        EXPECT_NEAR(10000, count, 500);
+
+    for (unsigned int i = 0; i < 1000; i++) {
+        double value = rng.R();
+        ASSERT_GE(value, 0);
+        ASSERT_LT(value, 1);
+    }
+}
+
+#endif
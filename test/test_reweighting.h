@@ -0,0 +1,34 @@
+#ifndef triangles_test_reweighting_h
+#define triangles_test_reweighting_h
+
+#include "gtest/gtest.h"
+#include "reweighting.h"
+
+
+TEST(Reweighting, curves) {
+    // the entropy of a binomial distribution, with a few unknown bins
+    unsigned int n = 2000;
+    std::vector<double> entropy(n + 1);
+    for (unsigned int t = 0; t <= n; t++)
+        entropy[t] = lgamma(n + 1.) - lgamma(t + 1.) - lgamma(n - t + 1.) - n*log(2.);
+    double removed = entropy[n/2 + 7];
+    entropy[n/2 + 7] = NAN;
+
+    reweighting::CanonicReweighting reweighting(entropy, 10);
+    std::vector<double> betas(reweighting::linspace(-3, 3, 13));
+    reweighting::CanonicCurves curves(reweighting.curves(betas, 2));
+    for (unsigned int i = 0; i < betas.size(); i++) {
+        std::vector<double> p(reweighting::canonic_distribution(entropy, betas[i], 10));
+        double mean = reweighting::canonic_triangles(entropy, betas[i], 10);
+        double variance = 0;
+        for (unsigned int t = 0; t <= n; t++)
+            variance += p[t]*(10 + t - mean)*(10 + t - mean);
+        EXPECT_NEAR(mean, curves.mean[i], 1e-9*n);
+        EXPECT_NEAR(variance, curves.variance[i], 1e-6*variance);
+    }
+    // Z(0) = \sum(exp(S)) == 1 but for the unknown bin, and the mean of a binomial is n*e^beta/(1 + e^beta)
+    EXPECT_NEAR(log(1 - exp(removed)), curves.log_Z[6], 1e-9);
+    EXPECT_NEAR(10 + n*exp(1.)/(1 + exp(1.)), curves.mean[8], 1e-2);
+}
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef triangles_test_sampler_h
+#define triangles_test_sampler_h
+
+#include "gtest/gtest.h"
+#include "sampler.h"
+#include "replica_exchange.h"
+#include "multiple_walkers.h"
+#include "parallel_tempering.h"
+#include "multicanonical.h"
+
+
+TEST(Acceptance, canonic) {
+    Random rng(4);
+    for (double beta : {0.5, -0.3}) {
+        CanonicAcceptance rule(beta);
+        for (unsigned int new_triangles : {0u, 5u, 10u, 40u, 100u}) {
+            unsigned int accepted = 0;
+            for (unsigned int i = 0; i < 20000; i++)
+                accepted += rule.accept(rng, 10, new_triangles);
+            double expected = std::min(1., exp(beta*((int)new_triangles - 10)));
+            EXPECT_NEAR(expected, accepted/20000., 0.015);
+        }
+    }
+}
+
+TEST(WangLandauSampler, checkpoint) {
+    FixedDegreeNetwork network(3, 4);
+    Histogram<unsigned int> histogram(0, network.get_triangles(), network.get_triangles());
+    Random rng(2);
+    WangLandauSampler sampler(rng, histogram, network);
+    sampler.set_one_over_t(true);
+    for (unsigned int i = 0; i < 3; i++)
+        sampler.perform_round_trip();
+    sampler.wang_landau_step();
+    sampler.perform_round_trip();
+    sampler.save_checkpoint("test_checkpoint.bin");
+
+    for (unsigned int i = 0; i < 3; i++)
+        sampler.perform_round_trip();
+
+    FixedDegreeNetwork restored_network(3, 4);
+    Histogram<unsigned int> restored_histogram(0, restored_network.get_triangles(), restored_network.get_triangles());
+    Random restored_rng(5);
+    WangLandauSampler restored(restored_rng, restored_histogram, restored_network);
+    restored.load_checkpoint("test_checkpoint.bin");
+    ASSERT_EQ(1, restored.get_wl_step());
+    ASSERT_EQ(1, restored.get_round_trip());
+    for (unsigned int i = 0; i < 3; i++)
+        restored.perform_round_trip();
+
+    EXPECT_EQ(sampler.get_f(), restored.get_f());
+    EXPECT_EQ(sampler.get_entropy(), restored.get_entropy());
+    EXPECT_EQ(sampler.get_mean_round_trip(), restored.get_mean_round_trip());
+    EXPECT_EQ(sampler.get_variance_round_trip(), restored.get_variance_round_trip());
+    EXPECT_EQ(histogram.count(), restored_histogram.count());
+    for (unsigned int bin = 0; bin <= histogram.bins(); bin++)
+        EXPECT_EQ(histogram[bin], restored_histogram[bin]);
+    for (unsigned int node_i = 0; node_i < network.getN(); node_i++)
+        EXPECT_EQ(network.get_links(node_i), restored_network.get_links(node_i));
+    EXPECT_EQ(rng.R(0, 1000000), restored_rng.R(0, 1000000));
+
+    // the restored sampler switches to the 1/t schedule as well
+    while (not sampler.get_in_one_over_t()) {
+        sampler.wang_landau_step();
+        restored.wang_landau_step();
+        ASSERT_EQ(sampler.get_in_one_over_t(), restored.get_in_one_over_t());
+    }
+    std::remove("test_checkpoint.bin");
+}
+
+TEST(WangLandauSampler, one_over_t) {
+    FixedDegreeNetwork network(3, 4);
+    Histogram<unsigned int> histogram(0, network.get_triangles(), network.get_triangles());
+    Random rng(2);
+    WangLandauSampler sampler(rng, histogram, network);
+    sampler.set_one_over_t(true);
+    sampler.sample_until(1e-5, 5, 0.8);
+
+    EXPECT_TRUE(sampler.get_in_one_over_t());
+    EXPECT_LT(sampler.get_f(), 1e-5);
+    std::vector<bool> visited(sampler.visited_bins());
+    unsigned int levels = (unsigned int)std::count(visited.begin(), visited.end(), true);
+    EXPECT_NEAR(levels/(double)sampler.get_steps(), sampler.get_f(), 1e-12);
+    for (unsigned int triangles = 2; triangles <= 10; triangles++)
+        EXPECT_LT(sampler.get_entropy()[triangles], sampler.get_entropy()[triangles - 1]);
+}
+
+TEST(WangLandauSampler, transition_matrix) {
+    FixedDegreeNetwork network(3, 4);
+    Histogram<unsigned int> histogram(0, network.get_triangles(), network.get_triangles());
+    Random rng(2);
+    WangLandauSampler sampler(rng, histogram, network);
+    sampler.set_transition_matrix(true);
+    sampler.sample_until(1e-3, 5, 0.8);
+
+    // the estimate of the transition matrix agrees with WL on the differences of entropy
+    std::vector<double> entropy(sampler.get_transition_matrix().entropy());
+    for (unsigned int triangles = 1; triangles <= 10; triangles++) {
+        ASSERT_FALSE(std::isnan(entropy[triangles]));
+        if (triangles >= 2) {
+            EXPECT_LT(entropy[triangles], entropy[triangles - 1]);
+        }
+        EXPECT_NEAR(entropy[triangles] - entropy[0],
+                    sampler.get_entropy()[triangles] - sampler.get_entropy()[0], 0.5);
+    }
+
+    sampler.set_transition_matrix(true, true);
+    EXPECT_TRUE(sampler.use_transition_matrix_entropy());
+    EXPECT_NEAR(entropy[5] - entropy[0], sampler.get_entropy()[5] - sampler.get_entropy()[0], 1e-12);
+}
+
+TEST(WindowSampler, target) {
+    FixedDegreeNetwork network(3, 8);
+    Histogram<unsigned int> histogram(14, 18, 4);
+    Random rng(2);
+    WindowSampler sampler(rng, histogram, network);
+    sampler.estimate_entropy(1e-4);
+
+    // with the entropy of the window, every number of triangles is about equally visited
+    for (unsigned int step = 0; step < 100000; step++)
+        sampler.markov_step();
+    for (unsigned int bin = 0; bin <= histogram.bins(); bin++)
+        EXPECT_NEAR(0.2, histogram[bin]/100000., 0.1);
+
+    unsigned int samples = 0;
+    sampler.set_target(16, 16);
+    sampler.sample(20, 100, [&samples](Network const& sample) {
+        EXPECT_EQ(16, sample.get_triangles());
+        samples++;
+    });
+    EXPECT_EQ(20, samples);
+}
+
+TEST(MulticanonicalSampler, reweighting) {
+    FixedDegreeNetwork network(3, 4);
+    unsigned int upper = network.get_triangles();
+    Histogram<unsigned int> histogram(0, upper, upper);
+    Random rng(2);
+    WangLandauSampler wang_landau(rng, histogram, network);
+    wang_landau.sample_until(1e-4, 5, 0.8);
+
+    std::vector<double> weights(wang_landau.get_entropy());
+    for (double & value : weights)
+        if (value == 0)
+            value = NAN;
+    MulticanonicalSampler sampler(network, 0, upper, weights, 2, 2);
+    sampler.sample(2000, 50, {"triangles"}, [](Network const& sample) {
+        return std::vector<double>(1, sample.get_triangles());
+    }, 2);
+
+    // every visited number of triangles is sampled, and the average of an observable
+    // reweights as the average of the entropy corrected by the visits
+    BinObservables observables(sampler.observables());
+    for (unsigned int triangles = 0; triangles <= 10; triangles++)
+        EXPECT_GT(observables.count(triangles), 0);
+    std::vector<double> entropy(sampler.entropy());
+    for (double beta : {-1., 0., 1.})
+        EXPECT_NEAR(reweighting::canonic_triangles(entropy, beta), sampler.canonic_average(0, beta), 1e-9);
+
+    // compared with a canonic sampler at beta = 0
+    Histogram<unsigned int> canonic_histogram(0, upper, upper);
+    CanonicSampler canonic(rng, canonic_histogram, network, 0);
+    canonic.sample(200000);
+    double mean = 0;
+    for (unsigned int triangles = 0; triangles <= upper; triangles++)
+        mean += triangles*canonic_histogram[triangles]/200000.;
+    EXPECT_NEAR(mean, sampler.canonic_average(0, 0), 0.1);
+}
+
+TEST(ReplicaExchangeWangLandau, windows) {
+    FixedDegreeNetwork network(3, 4);
+    ReplicaExchangeWangLandau sampler(network, 0, network.get_triangles(), 2, 0.75, 2);
+    EXPECT_EQ(0, sampler.get_window_lower(0));
+    EXPECT_EQ(network.get_triangles(), sampler.get_window_upper(1));
+    EXPECT_LT(sampler.get_window_lower(1), sampler.get_window_upper(0));
+
+    sampler.sample(8, 0.8, 1000, 2);
+    EXPECT_GT(sampler.exchange_acceptance(0), 0);
+
+    // the stitched entropy covers both ends of the range and, as for a single
+    // walker, decreases with the number of triangles
+    std::vector<double> entropy(sampler.entropy());
+    ASSERT_EQ(network.get_triangles() + 1, entropy.size());
+    EXPECT_FALSE(std::isnan(entropy[0]));
+    EXPECT_FALSE(std::isnan(entropy[network.get_triangles()]));
+    for (unsigned int triangles = 2; triangles <= 10; triangles++)
+        EXPECT_LT(entropy[triangles], entropy[triangles - 1]);
+}
+
+TEST(ReplicaExchangeWangLandau, narrow_windows) {
+    FixedDegreeNetwork network(3, 2);
+    for (unsigned int upper = 4; upper <= 12; upper++)
+        for (unsigned int windows = 1; windows <= 4; windows++) {
+            if (upper < ReplicaExchangeWangLandau::min_window_bins()*(1 + (windows - 1)*0.25))
+                continue;
+            ReplicaExchangeWangLandau sampler(network, 0, upper, windows);
+            for (unsigned int window = 0; window < windows; window++)
+                EXPECT_GE(sampler.get_window_upper(window) - sampler.get_window_lower(window),
+                          ReplicaExchangeWangLandau::min_window_bins());
+            EXPECT_EQ(upper, sampler.get_window_upper(windows - 1));
+        }
+    // ranges too narrow for windows of `min_window_bins()` bins are rejected
+    EXPECT_EXIT(ReplicaExchangeWangLandau(network, 0, 3, 4), ::testing::ExitedWithCode(1), "");
+    EXPECT_EXIT(ReplicaExchangeWangLandau(network, 5, 5, 1), ::testing::ExitedWithCode(1), "");
+}
+
+TEST(MultipleWalkerWangLandau, shared_entropy) {
+    FixedDegreeNetwork network(3, 4);
+    MultipleWalkerWangLandau sampler(network, 0, network.get_triangles(), 3);
+    sampler.sample(10, 10, 100, 2);
+    EXPECT_EQ(10, sampler.get_wl_step());
+    EXPECT_EQ(1./1024, sampler.get_f());
+
+    // as for a single walker, the entropy decreases with the number of triangles
+    std::vector<double> const& entropy = sampler.get_entropy();
+    for (unsigned int triangles = 2; triangles <= 10; triangles++)
+        EXPECT_LT(entropy[triangles], entropy[triangles - 1]);
+}
+
+TEST(MultipleWalkerWangLandau, replay) {
+    // every walker has its own stream, so runs are reproducible for any number of threads
+    FixedDegreeNetwork network(3, 4);
+    MultipleWalkerWangLandau sampler(network, 0, network.get_triangles(), 3);
+    MultipleWalkerWangLandau replay(network, 0, network.get_triangles(), 3);
+    sampler.sample(3, 6, 100, 1);
+    replay.sample(3, 6, 100, 3);
+    EXPECT_EQ(sampler.get_entropy(), replay.get_entropy());
+}
+
+TEST(ParallelTempering, ladder) {
+    FixedDegreeNetwork network(3, 4);
+    std::vector<double> betas = {-1, 0, 0.5, 1, 2};
+    ParallelTempering sampler(network, betas, 0, network.get_triangles());
+    sampler.sample(20000, 100, 50, 2);  // tunes the ladder and then resets the histograms
+    sampler.sample(10000, 100, 0, 2);
+
+    // the ends of the ladder are fixed, and the inner betas stay sorted
+    EXPECT_EQ(-1, sampler.get_beta(0));
+    EXPECT_EQ(2, sampler.get_beta(4));
+    for (unsigned int i = 0; i < 4; i++) {
+        EXPECT_LT(sampler.get_beta(i), sampler.get_beta(i + 1));
+        EXPECT_GT(sampler.swap_acceptance(i), 0);
+    }
+    EXPECT_GT(sampler.get_round_trips(), 0);
+
+    // the average number of triangles increases with beta
+    double previous_mean = -1;
+    for (unsigned int i = 0; i < 5; i++) {
+        Histogram<unsigned int> const& histogram = sampler.get_histogram(i);
+        double mean = 0;
+        for (unsigned int bin = 0; bin <= histogram.bins(); bin++)
+            mean += histogram.value(bin)*histogram[bin];
+        mean /= histogram.count();
+        EXPECT_GT(mean, previous_mean);
+        previous_mean = mean;
+        for (unsigned int node_i = 0; node_i < network.getN(); node_i++)
+            EXPECT_EQ(3, sampler.get_network(i).get_links(node_i).size());
+    }
+}
+
+#endif
@@ -184,4 +184,86 @@ TEST_F(TestMultiSquare, degree) {
     }
 }
 
+
+TEST_F(TestMultiSquare, link_index) {
+    Random rng(1);
+    FixedDegreeProposer proposer(rng);
+
+    for (unsigned int i = 0; i < 100; i++) {
+        proposer.propose(*network);
+
+        ASSERT_EQ(12, network->get_links_count());
+        std::set<Link> links;
+        for (unsigned int index = 0; index < network->get_links_count(); index++) {
+            Link link = network->get_link(index);
+            ASSERT_EQ(1, network->get_links(link.first).count(link.second));
+            links.insert(Link(std::min(link.first, link.second), std::max(link.first, link.second)));
+        }
+        ASSERT_EQ(12, links.size());
+    }
+}
+
+
+TEST_F(TestMultiSquare, delta_triangles) {
+    Random rng(1);
+    FixedDegreeProposer proposer(rng);
+
+    for (unsigned int i = 0; i < 1000; i++) {
+        GeneratedProposal proposal = proposer.generate_proposal(*network);
+        int old_triangles = network->get_triangles();
+        int delta = network->delta_triangles(proposal);
+
+        proposer.propose(*network, proposal);
+        ASSERT_EQ(old_triangles + delta, (int)network->get_triangles());
+    }
+}
+
+
+//! Network that exposes the triangle counting, to run it with several threads.
+class CountingNetwork : public Network {
+public:
+    CountingNetwork(unsigned int Nnodes, std::vector<std::set<unsigned int> > links) : Network(Nnodes, links) {}
+    using Network::compute_triangles;
+    using Network::compute_all_triangles;
+};
+
+
+TEST(Network, compute_all_triangles) {
+    Random rng(1);
+    unsigned int Nnodes = 3000;
+    std::vector<std::set<unsigned int> > links(Nnodes);
+    for (unsigned int link = 0; link < 30000; link++) {
+        // a few hubs make the degrees heterogeneous
+        unsigned int node_i = rng.R(0, 10) ? rng.R(0, Nnodes) : rng.R(0, 5);
+        unsigned int node_j = rng.R(0, Nnodes);
+        if (node_i != node_j) {
+            links[node_i].insert(node_j);
+            links[node_j].insert(node_i);
+        }
+    }
+
+    std::vector<unsigned int> expected(Nnodes, 0);
+    unsigned int expected_total = 0;
+    for (unsigned int node_i = 0; node_i < Nnodes; node_i++)
+        for (unsigned int node_j : links[node_i])
+            for (unsigned int node_k : links[node_j])
+                if (node_i < node_j and node_j < node_k and links[node_i].count(node_k)) {
+                    expected[node_i]++;
+                    expected[node_j]++;
+                    expected[node_k]++;
+                    expected_total++;
+                }
+
+    CountingNetwork network(Nnodes, links);
+    for (unsigned int threads = 1; threads <= 4; threads++) {
+        network.compute_all_triangles(threads);
+        ASSERT_EQ(expected_total, network.get_triangles());
+        for (unsigned int node_i = 0; node_i < Nnodes; node_i++)
+            ASSERT_EQ(expected[node_i], network.get_node_triangles(node_i));
+    }
+    // the count of a single node, on a non-const network
+    for (unsigned int node_i = 0; node_i < 10; node_i++)
+        ASSERT_EQ(expected[node_i], network.compute_triangles(node_i));
+}
+
 #endif